@@ -0,0 +1,48 @@
+#include "AudioThreadGuard.h"
+
+#if SIMPLESYNTH_CHECK_AUDIO_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local int audioThreadDepth = 0;
+    std::atomic<juce::uint64> allocationCount { 0 };
+
+    void* allocate(std::size_t size)
+    {
+        if (audioThreadDepth > 0)
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (auto* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void AudioThreadGuard::enter() noexcept              { ++audioThreadDepth; }
+void AudioThreadGuard::exit() noexcept               { --audioThreadDepth; }
+juce::uint64 AudioThreadGuard::getAllocationCount() noexcept
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)                                    { return allocate(size); }
+void* operator new[](std::size_t size)                                  { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept                                  { std::free(p); }
+void operator delete[](void* p) noexcept                                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                     { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { std::free(p); }
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Opt-in check that processBlock never touches the heap. Configure with
+// -DSIMPLESYNTH_CHECK_AUDIO_ALLOCATIONS=ON and the plugin replaces the global
+// operator new/delete with versions that count every allocation made while a
+// ScopedAudioThread is alive on the calling thread. The count is published in
+// the editor's telemetry, so it can be watched while dragging the controls.
+//
+// This only sees processBlock. The VST3 wrapper applies host parameter changes
+// and calls the parameter listeners before that; SimpleSynthHost's
+// SIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS covers the whole callback and is what
+// test_harness.py checks.
+//
+// With the option off (the default) all of this compiles away.
+namespace AudioThreadGuard
+{
+   #if SIMPLESYNTH_CHECK_AUDIO_ALLOCATIONS
+    void enter() noexcept;
+    void exit() noexcept;
+    juce::uint64 getAllocationCount() noexcept;
+    constexpr bool isEnabled() noexcept { return true; }
+   #else
+    inline void enter() noexcept {}
+    inline void exit() noexcept {}
+    inline juce::uint64 getAllocationCount() noexcept { return 0; }
+    constexpr bool isEnabled() noexcept { return false; }
+   #endif
+
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept { enter(); }
+        ~ScopedAudioThread() noexcept { exit(); }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Hands objects built off the audio thread to the audio thread with no
+// locks and no frees on the audio thread. Once adopted, an object belongs to
+// the audio thread:
+//   1. the message or housekeeping thread builds an object and publish()es it
+//   2. processBlock calls adopt() at a block boundary; the object it replaces
+//      is parked in 'retired'
+//   3. the processor's housekeeping thread deletes the parked object in
+//      collectGarbage()
+// A new object is only adopted once the previous one has been collected, so
+// there is always room to park it.
+template <typename ObjectType>
+class AudioThreadHandoff
+{
+public:
+    AudioThreadHandoff() = default;
+
+    ~AudioThreadHandoff()
+    {
+        std::unique_ptr<ObjectType>(pending.exchange(nullptr));
+        std::unique_ptr<ObjectType>(retired.exchange(nullptr));
+    }
+
+    // Any thread but the audio thread. An object published but not yet adopted is replaced.
+    void publish(std::unique_ptr<ObjectType> next)
+    {
+        std::unique_ptr<ObjectType>(pending.exchange(next.release(), std::memory_order_acq_rel));
+    }
+
+    // Audio thread, or any thread while audio is stopped. Returns true if the current object changed.
+    bool adopt() noexcept
+    {
+        if (retired.load(std::memory_order_acquire) != nullptr)
+            return false;
+
+        auto* next = pending.exchange(nullptr, std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+
+        retired.store(current.release(), std::memory_order_release);
+        current.reset(next);
+        return true;
+    }
+
+    // Audio thread
+    const ObjectType* get() const noexcept { return current.get(); }
+    ObjectType* get() noexcept { return current.get(); }
+
+    // Any thread but the audio thread
+    void collectGarbage()
+    {
+        std::unique_ptr<ObjectType>(retired.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+private:
+    std::unique_ptr<ObjectType> current;
+    std::atomic<ObjectType*> pending { nullptr };
+    std::atomic<ObjectType*> retired { nullptr };
+
+    AudioThreadHandoff(const AudioThreadHandoff&) = delete;
+    AudioThreadHandoff& operator=(const AudioThreadHandoff&) = delete;
+};
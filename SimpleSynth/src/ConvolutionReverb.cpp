@@ -0,0 +1,424 @@
+#include "ConvolutionReverb.h"
+
+#include <algorithm>
+
+namespace
+{
+    // acc += a * b over interleaved complex bins
+    void multiplyAdd(float* acc, const float* a, const float* b, int numBins) noexcept
+    {
+        for (int i = 0; i < 2 * numBins; i += 2)
+        {
+            const float re = a[i] * b[i] - a[i + 1] * b[i + 1];
+            const float im = a[i] * b[i + 1] + a[i + 1] * b[i];
+            acc[i] += re;
+            acc[i + 1] += im;
+        }
+    }
+
+    // Anti-aliasing before a response is resampled to a lower rate: passes
+    // antiAliasCutoff of the new rate, and run forwards then backwards (zero
+    // phase, twice the attenuation) so the response's onset doesn't move
+    constexpr double antiAliasCutoff = 0.4;
+    constexpr int antiAliasOrder = 16;
+
+    void lowpassInPlace(float* samples, int numSamples, double cutoff, double sampleRate)
+    {
+        const auto sections = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
+            (float) cutoff, sampleRate, antiAliasOrder);
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (auto* coefficients : sections)
+            {
+                juce::dsp::IIR::Filter<float> filter(coefficients);
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] = filter.processSample(samples[i]);
+            }
+
+            std::reverse(samples, samples + numSamples);
+        }
+    }
+}
+
+//==============================================================================
+PartitionedConvolver::PartitionedConvolver(const float* impulse, int impulseLength, int size)
+    : blockSize(size),
+      fftSize(2 * size),
+      spectrumSize(2 * (size + 1)),
+      numPartitions(juce::jmax(1, (impulseLength + size - 1) / size)),
+      fft(juce::findHighestSetBit((juce::uint32) (2 * size)))
+{
+    jassert(juce::isPowerOfTwo(size));
+
+    partitions.assign((size_t) (numPartitions * spectrumSize), 0.0f);
+    history.assign((size_t) (numPartitions * spectrumSize), 0.0f);
+    input.assign((size_t) blockSize, 0.0f);
+    work.assign((size_t) (2 * fftSize), 0.0f);
+    accumulated.assign((size_t) spectrumSize, 0.0f);
+    overlap.assign((size_t) blockSize, 0.0f);
+
+    for (int k = 0; k < numPartitions; ++k)
+    {
+        std::fill(work.begin(), work.end(), 0.0f);
+        const int offset = k * blockSize;
+        juce::FloatVectorOperations::copy(work.data(), impulse + offset, juce::jmin(blockSize, impulseLength - offset));
+
+        fft.performRealOnlyForwardTransform(work.data(), true);
+        juce::FloatVectorOperations::copy(spectrum(partitions, k), work.data(), spectrumSize);
+    }
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(input.begin(), input.end(), 0.0f);
+    std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+    std::fill(overlap.begin(), overlap.end(), 0.0f);
+    inputPosition = 0;
+    current = 0;
+}
+
+void PartitionedConvolver::process(const float* in, float* out, int numSamples) noexcept
+{
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - done, blockSize - inputPosition);
+        juce::FloatVectorOperations::copy(input.data() + inputPosition, in + done, chunk);
+
+        // Spectrum of the block so far, zero padded to the FFT size
+        juce::FloatVectorOperations::copy(work.data(), input.data(), blockSize);
+        std::fill(work.begin() + blockSize, work.end(), 0.0f);
+        fft.performRealOnlyForwardTransform(work.data(), true);
+
+        auto* newest = spectrum(history, current);
+        juce::FloatVectorOperations::copy(newest, work.data(), spectrumSize);
+
+        // Older blocks' sum plus the newest block times the first partition
+        juce::FloatVectorOperations::copy(work.data(), accumulated.data(), spectrumSize);
+        multiplyAdd(work.data(), newest, spectrum(partitions, 0), spectrumSize / 2);
+
+        // Some FFT back ends read the negative frequencies too
+        for (int bin = 1; bin < blockSize; ++bin)
+        {
+            work[(size_t) (2 * (fftSize - bin))] = work[(size_t) (2 * bin)];
+            work[(size_t) (2 * (fftSize - bin) + 1)] = -work[(size_t) (2 * bin + 1)];
+        }
+
+        fft.performRealOnlyInverseTransform(work.data());
+
+        juce::FloatVectorOperations::add(out + done, work.data() + inputPosition, chunk);
+        juce::FloatVectorOperations::add(out + done, overlap.data() + inputPosition, chunk);
+        inputPosition += chunk;
+        done += chunk;
+
+        if (inputPosition == blockSize)
+        {
+            // The block is complete: keep its second half for the next one, age
+            // the history and sum every partition but the first for the next block
+            juce::FloatVectorOperations::copy(overlap.data(), work.data() + blockSize, blockSize);
+            current = (current + numPartitions - 1) % numPartitions;
+
+            std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+            for (int k = 1; k < numPartitions; ++k)
+                multiplyAdd(accumulated.data(), spectrum(history, (current + k) % numPartitions),
+                            spectrum(partitions, k), spectrumSize / 2);
+
+            std::fill(input.begin(), input.end(), 0.0f);
+            inputPosition = 0;
+        }
+    }
+}
+
+//==============================================================================
+std::unique_ptr<ConvolutionReverb::Engine> ConvolutionReverb::Engine::create(const juce::AudioBuffer<float>& impulse,
+                                                                             double impulseSampleRate, double sampleRate)
+{
+    if (impulse.getNumChannels() == 0 || impulse.getNumSamples() == 0 || impulseSampleRate <= 0.0)
+        return nullptr;
+
+    const double ratio = impulseSampleRate / sampleRate;
+    const int length = juce::jmin((int) std::ceil(impulse.getNumSamples() / ratio),
+                                  (int) (maxImpulseSeconds * sampleRate));
+    const int numChannels = juce::jmin(2, impulse.getNumChannels());
+
+    juce::AudioBuffer<float> resampled(numChannels, length);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (ratio == 1.0)
+        {
+            resampled.copyFrom(ch, 0, impulse, ch, 0, juce::jmin(length, impulse.getNumSamples()));
+        }
+        else
+        {
+            const float* source = impulse.getReadPointer(ch);
+
+            // Going down in rate, what the new rate can't hold would fold back as aliasing
+            std::vector<float> filtered;
+            if (ratio > 1.0)
+            {
+                filtered.assign(source, source + impulse.getNumSamples());
+                lowpassInPlace(filtered.data(), (int) filtered.size(), antiAliasCutoff * sampleRate, impulseSampleRate);
+                source = filtered.data();
+            }
+
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, source, resampled.getWritePointer(ch), length, impulse.getNumSamples(), 0);
+        }
+    }
+
+    // Unit energy in the louder channel, so the wet signal sits near the dry level
+    double energy = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        double channelEnergy = 0.0;
+        for (int i = 0; i < length; ++i)
+            channelEnergy += (double) resampled.getSample(ch, i) * resampled.getSample(ch, i);
+
+        energy = juce::jmax(energy, channelEnergy);
+    }
+
+    if (energy <= 0.0)
+        return nullptr;
+
+    resampled.applyGain((float) (1.0 / std::sqrt(energy)));
+
+    auto engine = std::make_unique<Engine>();
+    engine->sampleRate = sampleRate;
+    engine->length = length;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const auto* samples = resampled.getReadPointer(juce::jmin(ch, numChannels - 1));
+        engine->head.push_back(std::make_unique<PartitionedConvolver>(samples, juce::jmin(length, headLength), headBlockSize));
+
+        if (length > headLength)
+            engine->tail.push_back(std::make_unique<PartitionedConvolver>(samples + headLength, length - headLength, tailBlockSize));
+    }
+
+    return engine;
+}
+
+//==============================================================================
+ConvolutionReverb::ConvolutionReverb()
+{
+    for (auto* buffers : { &tailInput, &tailPlayback, &wet, &catchUpInput, &jobInput, &jobOutput, &jobCatchUpInput })
+        for (auto& buffer : *buffers)
+            buffer.assign((size_t) tailBlockSize, 0.0f);
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    tailThread.signalThreadShouldExit();
+    jobReady.signal();
+    tailThread.stopThread(2000);
+}
+
+void ConvolutionReverb::setEngine(std::unique_ptr<Engine> newEngine)
+{
+    // Started before the engine can reach the audio thread, which will hand it jobs
+    if (newEngine != nullptr && !newEngine->tail.empty() && !tailThread.isThreadRunning())
+        tailThread.startThread(juce::Thread::Priority::high);
+
+    engine.publish(std::move(newEngine));
+}
+
+void ConvolutionReverb::collectGarbage()
+{
+    engine.collectGarbage();
+}
+
+void ConvolutionReverb::prepare()
+{
+    if (jobInFlight)
+    {
+        waitForJob();
+        jobInFlight = false;
+    }
+
+    engine.collectGarbage();
+    adoptEngine();
+    reset();
+}
+
+void ConvolutionReverb::reset() noexcept
+{
+    if (auto* current = engine.get())
+        for (auto& convolver : current->head)
+            convolver->reset();
+
+    for (auto* buffers : { &tailInput, &tailPlayback })
+        for (auto& buffer : *buffers)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+    tailPosition = 0;
+    discardJob = jobInFlight;
+    clearTailHistory = true;
+    catchUpPending = false;
+}
+
+void ConvolutionReverb::adoptEngine() noexcept
+{
+    // A new engine's convolvers start from silence
+    if (engine.adopt())
+    {
+        for (auto& buffer : tailPlayback)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+        clearTailHistory = false;
+        catchUpPending = false;
+    }
+}
+
+void ConvolutionReverb::waitForJob() noexcept
+{
+    while (!jobFinished.load(std::memory_order_acquire))
+        jobDone.wait(-1);
+}
+
+void ConvolutionReverb::process(float* left, float* right, int numSamples, float mix, bool nonRealtime) noexcept
+{
+    // Mid-block, the head and tail would switch responses at different times
+    if (tailPosition == 0 && !jobInFlight)
+        adoptEngine();
+
+    auto* current = engine.get();
+    if (current == nullptr || current->head.empty())
+        return;
+
+    const int numChannels = left == right ? 1 : 2;
+    float* const channels[] { left, right };
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - done, tailBlockSize - tailPosition);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* io = channels[ch] + done;
+            auto* wetChannel = wet[(size_t) ch].data();
+
+            juce::FloatVectorOperations::copy(tailInput[(size_t) ch].data() + tailPosition, io, chunk);
+            juce::FloatVectorOperations::copy(wetChannel, tailPlayback[(size_t) ch].data() + tailPosition, chunk);
+            current->head[(size_t) ch]->process(io, wetChannel, chunk);
+
+            juce::FloatVectorOperations::addWithMultiply(io, wetChannel, mix, chunk);
+        }
+
+        tailPosition += chunk;
+        done += chunk;
+
+        if (tailPosition == tailBlockSize)
+        {
+            finishTailBlock(numChannels, nonRealtime);
+            tailPosition = 0;
+
+            // The engine may have changed at the boundary, possibly to none
+            current = engine.get();
+            if (current->head.empty())
+                return;
+        }
+    }
+}
+
+void ConvolutionReverb::finishTailBlock(int numChannels, bool nonRealtime) noexcept
+{
+    if (jobInFlight)
+    {
+        if (nonRealtime)
+            waitForJob();
+
+        if (!jobFinished.load(std::memory_order_acquire))
+        {
+            // Late, and not worth waiting for: this block's tail is silent, and
+            // so is the late job's output, which is due now and will arrive a
+            // block late. The input block is kept for the next job so the
+            // history stays aligned. If one is kept already, the tail has to
+            // restart from silence instead.
+            lateTailBlocks.fetch_add(1, std::memory_order_relaxed);
+            for (auto& buffer : tailPlayback)
+                std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+            discardJob = true;
+
+            if (catchUpPending)
+            {
+                catchUpPending = false;
+                clearTailHistory = true;
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    catchUpInput[(size_t) ch].swap(tailInput[(size_t) ch]);
+
+                catchUpPending = true;
+            }
+
+            return;
+        }
+
+        jobInFlight = false;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (discardJob || ch >= jobChannels)
+                std::fill(tailPlayback[(size_t) ch].begin(), tailPlayback[(size_t) ch].end(), 0.0f);
+            else
+                tailPlayback[(size_t) ch].swap(jobOutput[(size_t) ch]);
+        }
+
+        discardJob = false;
+    }
+    else
+    {
+        for (auto& buffer : tailPlayback)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+    }
+
+    adoptEngine();
+
+    auto* current = engine.get();
+    if (current->tail.empty())
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        jobInput[(size_t) ch].swap(tailInput[(size_t) ch]);
+
+        if (catchUpPending)
+            jobCatchUpInput[(size_t) ch].swap(catchUpInput[(size_t) ch]);
+    }
+
+    jobEngine = current;
+    jobChannels = numChannels;
+    jobClearsHistory = clearTailHistory;
+    jobHasCatchUp = catchUpPending;
+    clearTailHistory = false;
+    catchUpPending = false;
+
+    jobFinished.store(false, std::memory_order_relaxed);
+    jobInFlight = true;
+    jobReady.signal();
+}
+
+void ConvolutionReverb::runTailJob() noexcept
+{
+    for (int ch = 0; ch < jobChannels; ++ch)
+    {
+        auto& convolver = *jobEngine->tail[(size_t) ch];
+        if (jobClearsHistory)
+            convolver.reset();
+
+        auto& output = jobOutput[(size_t) ch];
+
+        // Its output was due a block ago; the history still needs its input
+        if (jobHasCatchUp)
+            convolver.process(jobCatchUpInput[(size_t) ch].data(), output.data(), tailBlockSize);
+
+        std::fill(output.begin(), output.end(), 0.0f);
+        convolver.process(jobInput[(size_t) ch].data(), output.data(), tailBlockSize);
+    }
+
+    jobFinished.store(true, std::memory_order_release);
+    jobDone.signal();
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "AudioThreadHandoff.h"
+
+// Uniformly partitioned overlap-add convolution of one channel with one
+// stretch of impulse response. The partitions are transformed once, in the
+// constructor. The input block being filled is transformed again on every
+// call, so the output has no latency even for calls shorter than a block;
+// the older blocks' contribution is summed once per completed block.
+class PartitionedConvolver
+{
+public:
+    // Allocates everything; blockSize must be a power of two
+    PartitionedConvolver(const float* impulse, int impulseLength, int blockSize);
+
+    void reset() noexcept;
+
+    // Adds the convolved input to output
+    void process(const float* input, float* output, int numSamples) noexcept;
+
+private:
+    const int blockSize, fftSize, spectrumSize, numPartitions;
+    juce::dsp::FFT fft;
+
+    std::vector<float> partitions;  // numPartitions spectra of spectrumSize floats (interleaved complex)
+    std::vector<float> history;     // The last numPartitions input blocks' spectra, a ring from 'current'
+    std::vector<float> input, work, accumulated, overlap;
+    int inputPosition = 0;
+    int current = 0;
+
+    float* spectrum(std::vector<float>& spectra, int index) noexcept { return spectra.data() + index * spectrumSize; }
+};
+
+// Convolution with a loaded impulse response, on the voice mix.
+//
+// The response is split in two. The head, the first headLength samples, is
+// convolved on the audio thread in small partitions with no latency. The
+// rest is convolved in large partitions on a background thread, one
+// tailBlockSize block at a time: a block of input handed over at one block
+// boundary is collected at the next, and is due at the output exactly then,
+// because the tail starts headLength = 2 * tailBlockSize samples into the
+// response. In real time a block the thread hasn't finished is counted and
+// its tail, and the next one's, play as silence. The input block that
+// arrived meanwhile is kept and convolved ahead of the next job, so the
+// tail's history stays aligned. Offline, the audio thread waits for the
+// thread, so renders are identical every time.
+//
+// An Engine holds one response at one sample rate with all of its spectra
+// and state. It is built on the message thread and handed over at a tail
+// block boundary, while the background thread is idle. A default-constructed
+// Engine has no response and turns the effect off. The background thread
+// is started by the first engine that has a tail.
+class ConvolutionReverb
+{
+public:
+    static constexpr int headBlockSize = 256;
+    static constexpr int tailBlockSize = 2048;
+    static constexpr int headLength = 2 * tailBlockSize;
+    static constexpr double maxImpulseSeconds = 20.0;
+
+    class Engine
+    {
+    public:
+        // Message thread. Resamples the response to sampleRate (lowpassed first
+        // when that is lower), normalises it to unit energy and transforms its
+        // partitions. Longer responses are cut at maxImpulseSeconds.
+        static std::unique_ptr<Engine> create(const juce::AudioBuffer<float>& impulse,
+                                              double impulseSampleRate, double sampleRate);
+
+        double getSampleRate() const noexcept { return sampleRate; }
+        double getLengthSeconds() const noexcept { return length / sampleRate; }
+
+    private:
+        friend class ConvolutionReverb;
+
+        double sampleRate = 44100.0;
+        int length = 0;
+
+        // One of each per output channel; a mono response feeds both. No tail
+        // convolvers when the response fits in the head.
+        std::vector<std::unique_ptr<PartitionedConvolver>> head, tail;
+    };
+
+    ConvolutionReverb();
+    ~ConvolutionReverb();
+
+    // Message thread. Takes effect at the next tail block boundary.
+    // Starts the background thread if the engine needs it.
+    void setEngine(std::unique_ptr<Engine> newEngine);
+
+    // Any thread but the audio thread: frees an engine the audio thread has replaced
+    void collectGarbage();
+
+    // Audio stopped: finishes any tail block in progress and takes up a pending engine
+    void prepare();
+    void reset() noexcept;
+
+    // In place. Pass the same pointer twice for a mono bus. nonRealtime makes
+    // the audio thread wait for the tail thread.
+    void process(float* left, float* right, int numSamples, float mix, bool nonRealtime) noexcept;
+
+    // Tail blocks played as silence because the background thread was late
+    int getNumLateTailBlocks() const noexcept { return lateTailBlocks.load(std::memory_order_relaxed); }
+
+private:
+    class TailThread : public juce::Thread
+    {
+    public:
+        explicit TailThread(ConvolutionReverb& ownerReverb)
+            : Thread("Convolution tail"), owner(ownerReverb)
+        {
+        }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+                if (owner.jobReady.wait(-1) && !threadShouldExit())
+                    owner.runTailJob();
+        }
+
+    private:
+        ConvolutionReverb& owner;
+    };
+
+    AudioThreadHandoff<Engine> engine;
+
+    // Audio thread: the tail input block being filled, the tail output being played, and wet scratch
+    std::array<std::vector<float>, 2> tailInput, tailPlayback, wet;
+    int tailPosition = 0;
+    bool jobInFlight = false;
+    bool discardJob = false;        // Reset, or late, while a job was running: its output is stale
+    bool clearTailHistory = false;  // The next job starts the tail convolvers from silence
+
+    // Audio thread: an input block that arrived while the job was late, for the next job
+    std::array<std::vector<float>, 2> catchUpInput;
+    bool catchUpPending = false;
+
+    // Handed to the tail thread with jobReady, handed back with jobFinished
+    std::array<std::vector<float>, 2> jobInput, jobOutput, jobCatchUpInput;
+    Engine* jobEngine = nullptr;
+    int jobChannels = 0;
+    bool jobClearsHistory = false;
+    bool jobHasCatchUp = false;     // Convolve jobCatchUpInput, for the history only, before jobInput
+    std::atomic<bool> jobFinished { false };
+    juce::WaitableEvent jobReady, jobDone;
+
+    std::atomic<int> lateTailBlocks { 0 };
+    TailThread tailThread { *this };
+
+    void adoptEngine() noexcept;
+    void waitForJob() noexcept;
+    void finishTailBlock(int numChannels, bool nonRealtime) noexcept;
+    void runTailJob() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(ConvolutionReverb)
+};
@@ -0,0 +1,199 @@
+#include "FdnReverb.h"
+
+namespace
+{
+    // Line lengths spread geometrically over this range, each rounded up to a
+    // prime sample count so no two lines share a period
+    constexpr double minLineSeconds = 0.023;
+
+    int nextPrime(int n) noexcept
+    {
+        for (;; ++n)
+        {
+            bool prime = n > 1;
+            for (int d = 2; prime && d * d <= n; ++d)
+                prime = n % d != 0;
+
+            if (prime)
+                return n;
+        }
+    }
+
+    // Input and output taps, scaled so a 2 s tail sits near the dry level
+    constexpr float inputGain = 0.9f;
+    constexpr float outputGain = 0.9f;
+}
+
+void FdnReverb::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    int total = 0;
+    for (int i = 0; i < numLines; ++i)
+    {
+        const double seconds = minLineSeconds * std::pow(maxLineSeconds / minLineSeconds, (double) i / (numLines - 1));
+        const int length = nextPrime(juce::roundToInt(seconds * sampleRate));
+        const int size = juce::nextPowerOfTwo(length + 1);
+
+        lineLengths[(size_t) i] = length;
+        lineOffsets[(size_t) i] = total;
+        lineMasks[(size_t) i] = size - 1;
+        total += size;
+    }
+
+    memory.assign((size_t) total, 0.0f);
+
+    // Constant registers. Left feeds and reads the even lines, right the odd
+    // ones, with alternating signs; the mix spreads both across all lines.
+    auto load = [this](auto&& laneValue, std::array<Vector, numVectors>& target)
+    {
+        for (int i = 0; i < numLines; ++i)
+            lineValues[(size_t) i] = laneValue(i);
+
+        for (int r = 0; r < numVectors; ++r)
+            target[(size_t) r] = Vector::fromRawArray(lineValues.data() + r * lanes);
+    };
+
+    load([](int i) { return i % 2 == 0 ? ((i / 2) % 2 == 0 ? inputGain : -inputGain) : 0.0f; }, leftInput);
+    load([](int i) { return i % 2 == 1 ? ((i / 2) % 2 == 0 ? inputGain : -inputGain) : 0.0f; }, rightInput);
+    load([](int i) { return i % 2 == 0 ? ((i / 4) % 2 == 0 ? outputGain : -outputGain) : 0.0f; }, leftOutput);
+    load([](int i) { return i % 2 == 1 ? ((i / 4) % 2 == 0 ? outputGain : -outputGain) : 0.0f; }, rightOutput);
+
+    // Column m of the within-register Hadamard: lane l is -1 when l & m has odd parity
+    for (int m = 0; m < lanes; ++m)
+    {
+        for (int l = 0; l < lanes; ++l)
+        {
+            bool odd = false;
+            for (int bits = l & m; bits != 0; bits &= bits - 1)
+                odd = !odd;
+
+            lineValues[(size_t) l] = odd ? -1.0f : 1.0f;
+        }
+
+        hadamardColumns[(size_t) m] = Vector::fromRawArray(lineValues.data());
+    }
+
+    gainsDecaySeconds = 0.0f;
+    reset();
+}
+
+void FdnReverb::reset() noexcept
+{
+    std::fill(memory.begin(), memory.end(), 0.0f);
+
+    for (auto& state : dampingState)
+        state = Vector::expand(0.0f);
+
+    position = 0;
+}
+
+float FdnReverb::getDampingCoefficient(float cutoffHz) const noexcept
+{
+    return (float) (1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoffHz / sampleRate));
+}
+
+void FdnReverb::updateDecayGains(float decaySeconds) noexcept
+{
+    // Each line loses 60 dB per decaySeconds of its own length, so all of them
+    // decay at the same rate. The 1/sqrt(N) normalising the Hadamard is folded in.
+    const double normalise = 1.0 / std::sqrt((double) numLines);
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        const double lineSeconds = lineLengths[(size_t) i] / sampleRate;
+        lineValues[(size_t) i] = (float) (normalise * std::pow(10.0, -3.0 * lineSeconds / decaySeconds));
+    }
+
+    for (int r = 0; r < numVectors; ++r)
+        decayGains[(size_t) r] = Vector::fromRawArray(lineValues.data() + r * lanes);
+
+    gainsDecaySeconds = decaySeconds;
+}
+
+void FdnReverb::mix(std::array<Vector, numVectors>& values) const noexcept
+{
+    // Within each register: lane l becomes the sum over m of H[l][m] * lane m
+    for (auto& value : values)
+    {
+        const auto x = value;
+        value = hadamardColumns[0] * x.get(0);
+
+        for (int m = 1; m < lanes; ++m)
+            value += hadamardColumns[(size_t) m] * x.get((size_t) m);
+    }
+
+    // Across registers: butterflies between whole registers
+    for (int half = 1; half < numVectors; half *= 2)
+    {
+        for (int i = 0; i < numVectors; i += 2 * half)
+        {
+            for (int j = i; j < i + half; ++j)
+            {
+                const auto a = values[(size_t) j];
+                const auto b = values[(size_t) (j + half)];
+                values[(size_t) j] = a + b;
+                values[(size_t) (j + half)] = a - b;
+            }
+        }
+    }
+}
+
+void FdnReverb::process(float* left, float* right, int numSamples, const Settings& settings) noexcept
+{
+    if (memory.empty())
+        return;
+
+    if (settings.decaySeconds != gainsDecaySeconds)
+        updateDecayGains(settings.decaySeconds);
+
+    const bool mono = left == right;
+    const auto damping = Vector::expand(settings.dampingCoefficient);
+    std::array<Vector, numVectors> values;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        for (int i = 0; i < numLines; ++i)
+            lineValues[(size_t) i] = memory[(size_t) (lineOffsets[(size_t) i]
+                                                      + ((int) (position - (juce::uint32) lineLengths[(size_t) i]) & lineMasks[(size_t) i]))];
+
+        auto wetLeft = Vector::expand(0.0f);
+        auto wetRight = Vector::expand(0.0f);
+
+        for (int r = 0; r < numVectors; ++r)
+        {
+            auto& state = dampingState[(size_t) r];
+            state += (Vector::fromRawArray(lineValues.data() + r * lanes) - state) * damping;
+
+            values[(size_t) r] = state * decayGains[(size_t) r];
+            wetLeft += values[(size_t) r] * leftOutput[(size_t) r];
+            wetRight += values[(size_t) r] * rightOutput[(size_t) r];
+        }
+
+        mix(values);
+
+        const float inLeft = left[n];
+        const float inRight = right[n];
+
+        for (int r = 0; r < numVectors; ++r)
+        {
+            values[(size_t) r] += leftInput[(size_t) r] * inLeft + rightInput[(size_t) r] * inRight;
+            values[(size_t) r].copyToRawArray(lineValues.data() + r * lanes);
+        }
+
+        for (int i = 0; i < numLines; ++i)
+            memory[(size_t) (lineOffsets[(size_t) i] + ((int) position & lineMasks[(size_t) i]))] = lineValues[(size_t) i];
+
+        ++position;
+
+        if (mono)
+        {
+            left[n] = inLeft + settings.mix * 0.5f * (wetLeft.sum() + wetRight.sum());
+        }
+        else
+        {
+            left[n] = inLeft + settings.mix * wetLeft.sum();
+            right[n] = inRight + settings.mix * wetRight.sum();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+// Algorithmic reverb: a 16-line feedback delay network on the voice mix.
+//
+// The lines are packed into SIMD registers, lane by lane, and everything in
+// the feedback loop works on whole registers: the damping lowpass, the
+// per-line decay gains and the 16x16 Hadamard mix. The Hadamard is split
+// into its across-register part (butterflies between registers) and its
+// within-register part (a multiply-add of each broadcast lane with a
+// constant column of signs). Only reading and writing the lines, which sit
+// at different positions, goes through memory one sample per line.
+//
+// Each line is a power-of-two buffer allocated in prepare(); all lines share
+// one write counter and wrap with their own mask.
+class FdnReverb
+{
+public:
+    using Vector = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int numLines = 16;
+    static constexpr int lanes = (int) Vector::SIMDNumElements;
+    static constexpr int numVectors = numLines / lanes;
+    static_assert(numLines % lanes == 0 && (numVectors & (numVectors - 1)) == 0,
+                  "The Hadamard split needs a power-of-two number of registers");
+
+    struct Settings
+    {
+        float decaySeconds = 2.0f;          // Time to fall by 60 dB (RT60)
+        float dampingCoefficient = 1.0f;    // From getDampingCoefficient(); 1 is undamped
+        float mix = 0.0f;                   // Wet level; the dry signal always passes
+    };
+
+    // Allocates; call from prepareToPlay
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    float getDampingCoefficient(float cutoffHz) const noexcept;
+
+    // Longest round trip through one line, added to the RT60 for the tail length
+    static constexpr double maxLineSeconds = 0.1;
+
+    // In place. Pass the same pointer twice for a mono bus.
+    void process(float* left, float* right, int numSamples, const Settings& settings) noexcept;
+
+private:
+    alignas(Vector::SIMDRegisterSize) std::array<float, numLines> lineValues {};
+
+    std::array<Vector, numVectors> dampingState {}, decayGains {};
+    std::array<Vector, numVectors> leftInput {}, rightInput {}, leftOutput {}, rightOutput {};
+    std::array<Vector, lanes> hadamardColumns {};
+
+    std::vector<float> memory;
+    std::array<int, numLines> lineLengths {}, lineOffsets {}, lineMasks {};
+    juce::uint32 position = 0;
+
+    double sampleRate = 44100.0;
+    float gainsDecaySeconds = 0.0f;     // Decay the gains were computed for
+
+    void updateDecayGains(float decaySeconds) noexcept;
+    void mix(std::array<Vector, numVectors>& values) const noexcept;
+};
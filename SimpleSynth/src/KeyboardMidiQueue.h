@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+
+// Single-producer/single-consumer queue of short MIDI messages, preallocated.
+// The on-screen keyboard pushes from the message thread; processBlock pops on
+// the audio thread. Neither side locks or allocates, and a full queue drops
+// the newest event rather than blocking the UI.
+class KeyboardMidiQueue
+{
+public:
+    static constexpr int capacity = 256;
+
+    // Message thread
+    bool push(const juce::MidiMessage& message) noexcept
+    {
+        if (message.getRawDataSize() > 3)
+            return false;
+
+        auto scope = fifo.write(1);
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return false;
+
+        auto& event = events[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        event.size = (juce::uint8) message.getRawDataSize();
+        std::copy(message.getRawData(), message.getRawData() + event.size, event.bytes);
+        return true;
+    }
+
+    // Audio thread: calls handler(const MidiMessage&) for every queued event
+    template <typename Handler>
+    void popAll(Handler&& handler) noexcept
+    {
+        auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([this, &handler](int index)
+        {
+            const auto& event = events[(size_t) index];
+            handler(juce::MidiMessage(event.bytes, event.size));
+        });
+    }
+
+private:
+    struct Event
+    {
+        juce::uint8 bytes[3] {};
+        juce::uint8 size = 0;
+    };
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<Event, (size_t) capacity> events;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath>
+
+// Low-frequency oscillator evaluated at control rate.
+//
+// The processor moves it once per voice sub-block and the voices ramp towards
+// the resulting value, so a sine LFO costs one sin per sub-block however many
+// voices it modulates. Free-running LFOs advance by their rate; tempo-synced
+// ones take their phase straight from the host's beat position.
+class Lfo
+{
+public:
+    enum class Shape { sine, triangle, sawtooth, square, sampleAndHold };
+
+    void reset() noexcept
+    {
+        phase = 0.0;
+        syncedCycle = -1.0;
+        held = 0.0f;
+        random.setSeed(0x5eed);
+    }
+
+    // Free-running: moves on by a number of cycles
+    void advance(double cycles) noexcept
+    {
+        phase += cycles;
+        if (phase >= 1.0)
+        {
+            phase -= std::floor(phase);
+            held = random.nextFloat() * 2.0f - 1.0f;
+        }
+    }
+
+    // Tempo sync: position in cycles since the start of the host timeline
+    void sync(double cycles) noexcept
+    {
+        const double cycle = std::floor(cycles);
+        if (cycle != syncedCycle)
+        {
+            syncedCycle = cycle;
+            held = random.nextFloat() * 2.0f - 1.0f;
+        }
+        phase = cycles - cycle;
+    }
+
+    // -1..1 at the current phase; sample-and-hold changes once per cycle
+    float getValue(Shape shape) const noexcept
+    {
+        const float p = (float) phase;
+
+        switch (shape)
+        {
+            case Shape::sine:          return std::sin(p * juce::MathConstants<float>::twoPi);
+            case Shape::triangle:      return p < 0.5f ? 4.0f * p - 1.0f : 3.0f - 4.0f * p;
+            case Shape::sawtooth:      return 2.0f * p - 1.0f;
+            case Shape::square:        return p < 0.5f ? 1.0f : -1.0f;
+            case Shape::sampleAndHold: return held;
+        }
+
+        return 0.0f;
+    }
+
+private:
+    double phase = 0.0;
+    double syncedCycle = -1.0;
+    float held = 0.0f;
+    juce::Random random { 0x5eed };     // Fixed seed, so offline renders repeat exactly
+};
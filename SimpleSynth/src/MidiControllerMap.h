@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+// Per-channel table mapping MIDI CC numbers to parameter indices: 16 channels
+// x 128 controllers of atomic slots, so the audio thread resolves a control
+// change with one relaxed load and the editor can rebind while audio runs.
+// In learn mode the next learnable CC to arrive is bound to the waiting parameter.
+class MidiControllerMap
+{
+public:
+    static constexpr int numChannels = 16;
+    static constexpr int numControllers = 128;
+    static constexpr int unmapped = -1;
+
+    MidiControllerMap()
+    {
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        for (auto& slot : slots)
+            slot.store(unmapped, std::memory_order_relaxed);
+    }
+
+    // channel 1-16, or 0 for every channel
+    void map(int channel, int controller, int parameterIndex) noexcept
+    {
+        if (!juce::isPositiveAndBelow(controller, numControllers))
+            return;
+
+        for (int ch = 1; ch <= numChannels; ++ch)
+            if (channel == 0 || channel == ch)
+                slot(ch, controller).store((juce::int16) parameterIndex, std::memory_order_relaxed);
+    }
+
+    void unmapParameter(int parameterIndex) noexcept
+    {
+        for (auto& s : slots)
+            if (s.load(std::memory_order_relaxed) == parameterIndex)
+                s.store(unmapped, std::memory_order_relaxed);
+    }
+
+    // Audio thread: parameter index for this CC, or unmapped
+    int getParameterFor(int channel, int controller) const noexcept
+    {
+        if (channel < 1 || channel > numChannels || !juce::isPositiveAndBelow(controller, numControllers))
+            return unmapped;
+
+        return slot(channel, controller).load(std::memory_order_relaxed);
+    }
+
+    // Sustain and the channel-mode messages keep their fixed meaning
+    static bool isLearnable(int controller) noexcept
+    {
+        return controller != 64 && juce::isPositiveAndBelow(controller, 120);
+    }
+
+    void startLearn(int parameterIndex) noexcept { learnTarget.store(parameterIndex, std::memory_order_release); }
+    void cancelLearn() noexcept                  { learnTarget.store(unmapped, std::memory_order_release); }
+    int getLearnTarget() const noexcept          { return learnTarget.load(std::memory_order_acquire); }
+
+    // Audio thread: binds this CC to the parameter waiting in learn mode, replacing
+    // that parameter's previous bindings. Returns the parameter index, or unmapped.
+    int learn(int channel, int controller) noexcept
+    {
+        if (!isLearnable(controller) || getLearnTarget() == unmapped)
+            return unmapped;
+
+        const int target = learnTarget.exchange(unmapped, std::memory_order_acq_rel);
+        if (target != unmapped)
+        {
+            unmapParameter(target);
+            map(channel, controller, target);
+        }
+        return target;
+    }
+
+    // Message thread: saved by parameter ID so bindings survive parameter reordering
+    juce::ValueTree toValueTree(juce::AudioProcessor& processor) const
+    {
+        juce::ValueTree tree(treeType);
+        auto& params = processor.getParameters();
+
+        for (int ch = 1; ch <= numChannels; ++ch)
+        {
+            for (int cc = 0; cc < numControllers; ++cc)
+            {
+                const int index = slot(ch, cc).load(std::memory_order_relaxed);
+                if (auto* param = dynamic_cast<juce::HostedAudioProcessorParameter*>(params[index]))
+                    tree.appendChild({ "CC", { { "channel", ch }, { "controller", cc }, { "parameter", param->getParameterID() } } },
+                                     nullptr);
+            }
+        }
+        return tree;
+    }
+
+    void fromValueTree(const juce::ValueTree& tree, juce::AudioProcessor& processor)
+    {
+        if (!tree.hasType(treeType))
+            return;
+
+        clear();
+        auto& params = processor.getParameters();
+
+        for (const auto& binding : tree)
+        {
+            const auto parameterID = binding.getProperty("parameter").toString();
+
+            for (int i = 0; i < params.size(); ++i)
+                if (auto* param = dynamic_cast<juce::HostedAudioProcessorParameter*>(params[i]))
+                    if (param->getParameterID() == parameterID)
+                        map((int) binding.getProperty("channel"), (int) binding.getProperty("controller"), i);
+        }
+    }
+
+    static inline const juce::Identifier treeType { "MIDI_CC_MAP" };
+
+private:
+    std::array<std::atomic<juce::int16>, (size_t) (numChannels * numControllers)> slots;
+    std::atomic<int> learnTarget { unmapped };
+
+    std::atomic<juce::int16>& slot(int channel, int controller) noexcept
+    {
+        return slots[(size_t) ((channel - 1) * numControllers + controller)];
+    }
+
+    const std::atomic<juce::int16>& slot(int channel, int controller) const noexcept
+    {
+        return slots[(size_t) ((channel - 1) * numControllers + controller)];
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(MidiControllerMap)
+};
@@ -0,0 +1,95 @@
+#include "ModulationMatrix.h"
+
+#include <utility>
+
+namespace
+{
+    // Entry (source - 1) * numDestinations + destination: 'none' has no routes
+    template <int... indices>
+    constexpr std::array<ModulationMatrix::RouteFunction, sizeof...(indices)>
+        makeRouteTable(std::integer_sequence<int, indices...>)
+    {
+        return { &ModulationMatrix::evaluateRoute<ModulationMatrix::none + 1 + indices / ModulationMatrix::numDestinations,
+                                                  indices % ModulationMatrix::numDestinations>... };
+    }
+
+    constexpr auto routeTable = makeRouteTable(
+        std::make_integer_sequence<int, (ModulationMatrix::numSources - 1) * ModulationMatrix::numDestinations>());
+}
+
+ModulationMatrix::RouteFunction ModulationMatrix::getRouteFunction(int source, int destination) noexcept
+{
+    jassert(source > none && source < numSources && destination >= 0 && destination < numDestinations);
+    return routeTable[(size_t) ((source - 1) * numDestinations + destination)];
+}
+
+void ModulationMatrix::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        const auto name = "Mod " + juce::String(slot + 1) + " ";
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(getParameterID(slot, "Source"), 1),
+            name + "Source",
+            juce::StringArray{"None", "Envelope", "Velocity", "Key", "Pressure", "Timbre", "Mod Wheel", "LFO 1", "LFO 2"},
+            none
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(getParameterID(slot, "Destination"), 1),
+            name + "Destination",
+            juce::StringArray{"Pitch", "Gain", "Cutoff", "Pan"},
+            pitch
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(getParameterID(slot, "Amount"), 1),
+            name + "Amount",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.001f),
+            0.0f
+        ));
+    }
+}
+
+juce::String ModulationMatrix::getParameterID(int slot, const char* name)
+{
+    return "mod" + juce::String(slot + 1) + name;
+}
+
+juce::StringArray ModulationMatrix::getRoutingParameterIDs()
+{
+    juce::StringArray ids;
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        ids.add(getParameterID(slot, "Source"));
+        ids.add(getParameterID(slot, "Destination"));
+    }
+    return ids;
+}
+
+std::unique_ptr<ModulationMatrix::Program> ModulationMatrix::compile(juce::AudioProcessorValueTreeState& state)
+{
+    auto program = std::make_unique<Program>();
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        auto* source = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(getParameterID(slot, "Source")));
+        auto* destination = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(getParameterID(slot, "Destination")));
+        auto* amount = state.getRawParameterValue(getParameterID(slot, "Amount"));
+
+        if (source == nullptr || destination == nullptr || amount == nullptr || source->getIndex() == none)
+            continue;
+
+        Routing routing;
+        routing.function = getRouteFunction(source->getIndex(), destination->getIndex());
+        routing.amount = amount;
+
+        if (isPerVoice(source->getIndex()))
+            program->voiceRoutings[(size_t) program->numVoiceRoutings++] = routing;
+        else
+            program->sharedRoutings[(size_t) program->numSharedRoutings++] = routing;
+    }
+
+    return program;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Modulation matrix: numSlots routings of a source to a destination with an amount.
+//
+// The slots are ordinary parameters ("mod1Source", "mod1Destination",
+// "mod1Amount", ...), so they are automatable and saved with the state.
+// Whenever a source or destination changes, a background thread compiles the
+// active slots into a Program and hands it to the audio thread. A Program is
+// a flat list of multiply-adds with each slot's amount resolved to its
+// parameter atomic, split into routings whose source is shared by all voices
+// (evaluated once per sub-block) and routings whose source is per voice
+// (evaluated once per voice per sub-block). Each routing calls the
+// instantiation of evaluateRoute() for its source and destination, so the
+// indices and depth are constants in its code. Unused slots cost nothing.
+class ModulationMatrix
+{
+public:
+    static constexpr int numSlots = 8;
+
+    // Choice indices of the Source and Destination parameters
+    enum Source { none, envelope, velocity, key, pressure, timbre, modWheel, lfo1, lfo2, numSources };
+    enum Destination { pitch, gain, cutoff, pan, numDestinations };
+
+    using SourceValues = std::array<float, numSources>;
+    using DestinationValues = std::array<float, numDestinations>;
+
+    // Destination movement for a source at 1 with amount 1: semitones, gain
+    // (the level is scaled by 1 + sum), octaves, pan width
+    static constexpr float destinationDepths[numDestinations] { 12.0f, 1.0f, 4.0f, 1.0f };
+
+    static bool isPerVoice(int source) noexcept { return source != lfo1 && source != lfo2; }
+
+    // destinations[d] += sources[s] * amount * depth, with s, d and the depth
+    // fixed at compile time
+    template <int source, int destination>
+    static void evaluateRoute(const SourceValues& sources, DestinationValues& destinations, float amount) noexcept
+    {
+        static_assert(source > none && source < numSources && destination >= 0 && destination < numDestinations);
+        destinations[(size_t) destination] += sources[(size_t) source] * amount * destinationDepths[destination];
+    }
+
+    using RouteFunction = void (*)(const SourceValues&, DestinationValues&, float) noexcept;
+
+    // The evaluateRoute() instantiation for a source other than none
+    static RouteFunction getRouteFunction(int source, int destination) noexcept;
+
+    struct Routing
+    {
+        RouteFunction function = nullptr;
+        const std::atomic<float>* amount = nullptr;
+    };
+
+    class Program
+    {
+    public:
+        // Adds the routings' contributions to 'destinations'
+        void evaluateShared(const SourceValues& sources, DestinationValues& destinations) const noexcept
+        {
+            evaluate(sharedRoutings.data(), numSharedRoutings, sources, destinations);
+        }
+
+        void evaluatePerVoice(const SourceValues& sources, DestinationValues& destinations) const noexcept
+        {
+            evaluate(voiceRoutings.data(), numVoiceRoutings, sources, destinations);
+        }
+
+        bool hasPerVoiceRoutings() const noexcept { return numVoiceRoutings > 0; }
+
+    private:
+        friend class ModulationMatrix;
+
+        std::array<Routing, numSlots> sharedRoutings, voiceRoutings;
+        int numSharedRoutings = 0;
+        int numVoiceRoutings = 0;
+
+        static void evaluate(const Routing* routings, int count, const SourceValues& sources,
+                             DestinationValues& destinations) noexcept
+        {
+            for (int i = 0; i < count; ++i)
+                routings[i].function(sources, destinations, routings[i].amount->load(std::memory_order_relaxed));
+        }
+    };
+
+    static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    // "mod1Source", "mod3Amount", ...
+    static juce::String getParameterID(int slot, const char* name);
+
+    // Source and destination IDs: changing one of these requires a recompile
+    static juce::StringArray getRoutingParameterIDs();
+
+    // Any thread but the audio thread
+    static std::unique_ptr<Program> compile(juce::AudioProcessorValueTreeState& state);
+};
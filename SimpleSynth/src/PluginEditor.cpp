@@ -2,27 +2,218 @@
 #include "PluginEditor.h"
 
 SimpleSynthAudioProcessorEditor::SimpleSynthAudioProcessorEditor(SimpleSynthAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p),
+      scope(p.getScopeRing()),
+      spectrum(p.getScopeRing()),
+      keyboard(p.getKeyboardState(), juce::MidiKeyboardComponent::horizontalKeyboard)
 {
-    setSize(400, 300);
+    auto& state = p.getValueTreeState();
+
+    frequencySlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    frequencySlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 70, 20);
+    frequencySlider.setTextValueSuffix(" Hz");
+    addAndMakeVisible(frequencySlider);
+    frequencyAttachment = std::make_unique<SliderAttachment>(state, ID::frequency, frequencySlider);
+
+    gainSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    gainSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    addAndMakeVisible(gainSlider);
+    gainAttachment = std::make_unique<SliderAttachment>(state, ID::gain, gainSlider);
+
+    // Items must exist before the attachment syncs the selection
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(ID::waveform)))
+        waveformBox.addItemList(choice->choices, 1);
+    addAndMakeVisible(waveformBox);
+    waveformAttachment = std::make_unique<ComboBoxAttachment>(state, ID::waveform, waveformBox);
+
+    setUpLabel(frequencyLabel, "Frequency", frequencySlider);
+    setUpLabel(gainLabel, "Gain", gainSlider);
+    setUpLabel(waveformLabel, "Waveform", waveformBox);
+
+    addAndMakeVisible(scope);
+    addAndMakeVisible(spectrum);
+
+    keyboard.setAvailableRange(36, 96);
+    keyboard.setKeyWidth(14.0f);
+    addAndMakeVisible(keyboard);
+
+    // See right-clicks on the controls too, for MIDI learn
+    addMouseListener(this, true);
+
+    setSize(600, 500);
+    setFrameRate(defaultFrameRate);
 }
 
 SimpleSynthAudioProcessorEditor::~SimpleSynthAudioProcessorEditor()
 {
+    removeMouseListener(this);
+    stopTimer();
+}
+
+juce::RangedAudioParameter* SimpleSynthAudioProcessorEditor::getParameterForControl(juce::Component* component)
+{
+    auto& state = audioProcessor.getValueTreeState();
+
+    for (auto* c = component; c != nullptr && c != this; c = c->getParentComponent())
+    {
+        if (c == &frequencySlider) return state.getParameter(ID::frequency);
+        if (c == &gainSlider)      return state.getParameter(ID::gain);
+        if (c == &waveformBox)     return state.getParameter(ID::waveform);
+    }
+    return nullptr;
+}
+
+void SimpleSynthAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+    if (!e.mods.isPopupMenu())
+        return;
+
+    auto* param = getParameterForControl(e.eventComponent);
+    if (param == nullptr)
+        return;
+
+    auto& ccMap = audioProcessor.getControllerMap();
+    const int index = param->getParameterIndex();
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader(param->getName(32));
+    menu.addItem("MIDI Learn", [&ccMap, index] { ccMap.startLearn(index); });
+    menu.addItem("Clear MIDI CC", [&ccMap, index] { ccMap.unmapParameter(index); });
+    if (ccMap.getLearnTarget() != MidiControllerMap::unmapped)
+        menu.addItem("Cancel Learn", [&ccMap] { ccMap.cancelLearn(); });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(e.eventComponent));
+}
+
+void SimpleSynthAudioProcessorEditor::setUpLabel(juce::Label& label, const juce::String& text,
+                                                 juce::Component& attachedTo)
+{
+    label.setText(text, juce::dontSendNotification);
+    label.setFont(12.0f);
+    label.attachToComponent(&attachedTo, false);
+    addAndMakeVisible(label);
+}
+
+void SimpleSynthAudioProcessorEditor::setFrameRate(int framesPerSecond)
+{
+    startTimerHz(juce::jlimit(1, maxFrameRate, framesPerSecond));
+}
+
+void SimpleSynthAudioProcessorEditor::timerCallback()
+{
+    const int learnTarget = audioProcessor.getControllerMap().getLearnTarget();
+    if (learnTarget != shownLearnTarget)
+    {
+        shownLearnTarget = learnTarget;
+        repaint(getLocalBounds().removeFromTop(60));
+    }
+
+    // Each view skips its work unless new audio arrived, and repaints only itself
+    scope.update();
+    spectrum.setSampleRate(audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 44100.0);
+    spectrum.update();
+
+    if (!audioProcessor.getTelemetry().read(telemetry))
+        return;  // Raced the audio thread; try again next frame
+
+    // Only redraw when the processor has rendered since the last frame
+    if (telemetry.blockCounter != lastBlockCounter)
+    {
+        lastBlockCounter = telemetry.blockCounter;
+        rebuildTelemetryPath();
+        repaint(telemetryArea);
+    }
 }
 
 void SimpleSynthAudioProcessorEditor::paint(juce::Graphics& g)
 {
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
 
+    auto header = getLocalBounds().removeFromTop(60);
+
     g.setColour(juce::Colours::white);
     g.setFont(20.0f);
-    g.drawText("SimpleSynth", getLocalBounds(), juce::Justification::centred, true);
+    g.drawText("SimpleSynth", header.removeFromTop(header.getHeight() / 2), juce::Justification::centredBottom, true);
 
     g.setFont(14.0f);
-    g.drawText("Send MIDI notes to play", getLocalBounds().removeFromBottom(100), juce::Justification::centred, true);
+    if (auto* learning = audioProcessor.getParameters()[shownLearnTarget])
+        g.drawText("MIDI learn: move a controller for " + learning->getName(32), header, juce::Justification::centred, true);
+    else
+        g.drawText("Send MIDI notes or play the keyboard", header, juce::Justification::centred, true);
+
+    paintTelemetry(g);
+}
+
+void SimpleSynthAudioProcessorEditor::paintTelemetry(juce::Graphics& g)
+{
+    auto area = telemetryArea;
+
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.setFont(12.0f);
+    auto stats = "Voices: " + juce::String(telemetry.activeVoices)
+               + "   Env: " + juce::String(telemetry.voiceLevels[0], 2)
+               + "   Block: " + juce::String(telemetry.blockMicroseconds, 1) + " us ("
+               + juce::String(telemetry.blockLoad * 100.0f, 1) + "%)";
+
+    if (AudioThreadGuard::isEnabled())
+        stats << "   Audio allocs: " << juce::String((juce::int64) telemetry.audioThreadAllocations);
+
+    g.drawText(stats, area.removeFromTop(20), juce::Justification::centredLeft, true);
+
+    g.setColour(juce::Colours::white.withAlpha(0.2f));
+    g.drawRect(getTelemetryWaveArea());
+
+    g.setColour(juce::Colours::lightgreen);
+    g.strokePath(telemetryPath, juce::PathStrokeType(1.5f));
+}
+
+juce::Rectangle<float> SimpleSynthAudioProcessorEditor::getTelemetryWaveArea() const
+{
+    return telemetryArea.withTrimmedTop(20).toFloat().reduced(0.0f, 4.0f);
+}
+
+void SimpleSynthAudioProcessorEditor::rebuildTelemetryPath()
+{
+    telemetryPath.clear();
+
+    if (telemetry.numWaveformPoints < 2)
+        return;
+
+    const auto wave = getTelemetryWaveArea();
+    telemetryPath.preallocateSpace(telemetry.numWaveformPoints * 3);
+
+    const float dx = wave.getWidth() / (float) (telemetry.numWaveformPoints - 1);
+    for (int i = 0; i < telemetry.numWaveformPoints; ++i)
+    {
+        const float y = wave.getCentreY() - juce::jlimit(-1.0f, 1.0f, telemetry.waveform[i]) * wave.getHeight() * 0.5f;
+        if (i == 0)
+            telemetryPath.startNewSubPath(wave.getX(), y);
+        else
+            telemetryPath.lineTo(wave.getX() + dx * (float) i, y);
+    }
 }
 
 void SimpleSynthAudioProcessorEditor::resized()
 {
+    auto area = getLocalBounds().reduced(10);
+    area.removeFromTop(50);
+
+    // Labels sit above their controls, so leave room for them
+    auto controls = area.removeFromTop(70).withTrimmedTop(20).withHeight(24);
+    const int columnWidth = controls.getWidth() / 3;
+    frequencySlider.setBounds(controls.removeFromLeft(columnWidth).reduced(5, 0));
+    gainSlider.setBounds(controls.removeFromLeft(columnWidth).reduced(5, 0));
+    waveformBox.setBounds(controls.reduced(5, 0));
+    area.removeFromTop(10);
+
+    telemetryArea = area.removeFromTop(70);
+    rebuildTelemetryPath();
+    area.removeFromTop(10);
+
+    auto views = area.removeFromTop(190);
+    scope.setBounds(views.removeFromLeft(views.getWidth() / 2).withTrimmedRight(5));
+    spectrum.setBounds(views.withTrimmedLeft(5));
+
+    area.removeFromTop(10);
+    keyboard.setBounds(area);
 }
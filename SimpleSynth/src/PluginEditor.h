@@ -2,18 +2,87 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "Visualizers.h"
 
-class SimpleSynthAudioProcessorEditor : public juce::AudioProcessorEditor
+class SimpleSynthAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                        private juce::Timer
 {
 public:
+    static constexpr int defaultFrameRate = 30;
+    static constexpr int maxFrameRate = 60;
+
     SimpleSynthAudioProcessorEditor(SimpleSynthAudioProcessor&);
     ~SimpleSynthAudioProcessorEditor() override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Right-click on a control offers MIDI learn
+    void mouseDown(const juce::MouseEvent&) override;
+
+    // How often the telemetry is polled and redrawn, capped at maxFrameRate
+    void setFrameRate(int framesPerSecond);
+
 private:
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+
+    // A right-click opens the editor's MIDI learn menu, so it must not also
+    // move the slider: popup-menu clicks never reach Slider's drag handling
+    class MidiLearnSlider : public juce::Slider
+    {
+    public:
+        void mouseDown(const juce::MouseEvent& e) override
+        {
+            if (!e.mods.isPopupMenu())
+                Slider::mouseDown(e);
+        }
+
+        void mouseDrag(const juce::MouseEvent& e) override
+        {
+            if (!e.mods.isPopupMenu())
+                Slider::mouseDrag(e);
+        }
+
+        void mouseUp(const juce::MouseEvent& e) override
+        {
+            if (!e.mods.isPopupMenu())
+                Slider::mouseUp(e);
+        }
+    };
+
     SimpleSynthAudioProcessor& audioProcessor;
 
+    // Controls are bound through APVTS attachments; declared before the
+    // attachments so the attachments are destroyed first
+    MidiLearnSlider frequencySlider;
+    MidiLearnSlider gainSlider;
+    juce::ComboBox waveformBox;
+    juce::Label frequencyLabel;
+    juce::Label gainLabel;
+    juce::Label waveformLabel;
+
+    std::unique_ptr<SliderAttachment> frequencyAttachment;
+    std::unique_ptr<SliderAttachment> gainAttachment;
+    std::unique_ptr<ComboBoxAttachment> waveformAttachment;
+
+    // Telemetry is polled from the processor's seqlock; the UI never locks against processBlock
+    TelemetryFrame telemetry;
+    juce::uint64 lastBlockCounter = 0;
+    int shownLearnTarget = MidiControllerMap::unmapped;
+    juce::Rectangle<int> telemetryArea;
+    juce::Path telemetryPath;  // Waveform of the last telemetry frame, rebuilt only when it changes
+
+    ScopeView scope;
+    SpectrumView spectrum;
+    juce::MidiKeyboardComponent keyboard;
+
+    void timerCallback() override;
+    void paintTelemetry(juce::Graphics&);
+    void rebuildTelemetryPath();
+    juce::Rectangle<float> getTelemetryWaveArea() const;
+    void setUpLabel(juce::Label&, const juce::String& text, juce::Component& attachedTo);
+    juce::RangedAudioParameter* getParameterForControl(juce::Component*);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleSynthAudioProcessorEditor)
 };
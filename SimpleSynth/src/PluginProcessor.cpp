@@ -1,6 +1,38 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // Tempo-synced lengths, matching the LFO and delay Division parameters' choices
+    const juce::StringArray noteDivisionNames { "4 Bars", "2 Bars", "1 Bar", "1/2", "1/4", "1/8", "1/16", "1/32",
+                                               "1/4 Triplet", "1/8 Triplet", "1/16 Triplet", "1/4 Dotted", "1/8 Dotted" };
+    constexpr double noteDivisionBeats[] { 16.0, 8.0, 4.0, 2.0, 1.0, 0.5, 0.25, 0.125,
+                                          2.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0, 1.5, 0.75 };
+
+    // The delay's divisions start at "1/2": a bar or more doesn't fit in its
+    // line at ordinary tempos. The longest, 2 beats, fills it at 60 BPM.
+    constexpr int firstDelayDivision = 3;
+
+    // Modulation at full LFO amount
+    constexpr float lfoPitchSemitones = 12.0f;
+    constexpr float lfoCutoffOctaves = 4.0f;
+
+    // $SIMPLESYNTH_IMPULSE_RESPONSE, relative to the working directory; File() when not set
+    juce::File getDefaultImpulseResponseFile()
+    {
+        auto path = juce::SystemStats::getEnvironmentVariable("SIMPLESYNTH_IMPULSE_RESPONSE", {});
+        return path.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(path) : juce::File();
+    }
+
+    void applyModulation(const ModulationMatrix::DestinationValues& values, SynthVoice::BlockParameters& block)
+    {
+        block.pitchSemitones += values[ModulationMatrix::pitch];
+        block.gainFactor *= juce::jmax(0.0f, 1.0f + values[ModulationMatrix::gain]);
+        block.cutoffOctaves += values[ModulationMatrix::cutoff];
+        block.panOffset += values[ModulationMatrix::pan];
+    }
+}
+
 SimpleSynthAudioProcessor::SimpleSynthAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
@@ -10,111 +42,863 @@ SimpleSynthAudioProcessor::SimpleSynthAudioProcessor()
     frequencyParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::frequency));
     gainParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::gain));
     waveformParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(ID::waveform));
+    bendRangeParam = dynamic_cast<juce::AudioParameterInt*>(parameters.getParameter(ID::bendRange));
+    mpeParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::mpe));
+    playModeParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(ID::playMode));
+    glideModeParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(ID::glideMode));
+    glideTimeParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::glideTime));
+    cutoffParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::cutoff));
+    panParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::pan));
+
+    delayParams.enabled = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::delay));
+    delayParams.time = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::delayTime));
+    delayParams.sync = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::delaySync));
+    delayParams.division = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(ID::delayDivision));
+    delayParams.feedback = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::delayFeedback));
+    delayParams.damping = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::delayDamping));
+    delayParams.mix = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::delayMix));
+    delayParams.pingPong = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::delayPingPong));
+
+    reverbParams.enabled = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::reverb));
+    reverbParams.decay = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::reverbDecay));
+    reverbParams.damping = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::reverbDamping));
+    reverbParams.mix = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::reverbMix));
+
+    convolutionParam = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ID::convolution));
+    convolutionMixParam = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(ID::convolutionMix));
+
+    for (int i = 0; i < numLfos; ++i)
+    {
+        auto& lfo = lfoParams[(size_t) i];
+        lfo.shape = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(getLfoParameterID(i, "Shape")));
+        lfo.rate = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(getLfoParameterID(i, "Rate")));
+        lfo.sync = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(getLfoParameterID(i, "Sync")));
+        lfo.division = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(getLfoParameterID(i, "Division")));
+        lfo.destination = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(getLfoParameterID(i, "Destination")));
+        lfo.amount = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter(getLfoParameterID(i, "Amount")));
+    }
+
+    presetBank = PresetBank::loadFromFile(PresetBank::getDefaultBankFile(), *this);
+    if (presetBank == nullptr)
+        presetBank = PresetBank::createDefault(*this);
+
+    setTuning(createStartupTuning());
+    tuning.adopt();
+    updateNoteIncrements();
+
+    for (auto& id : ModulationMatrix::getRoutingParameterIDs())
+        parameters.addParameterListener(id, this);
+
+    rebuildModulation();
+    modulation.adopt();
+
+    loadStartupImpulseResponse();
+
+    resetControllerMap();
+    startTimerHz(30);
+
+    // The keyboard state is only ever driven from the message thread; its
+    // events reach processBlock through keyboardQueue, never its own lock
+    keyboardState.addListener(this);
 }
 
 SimpleSynthAudioProcessor::~SimpleSynthAudioProcessor()
 {
+    keyboardState.removeListener(this);
+    stopTimer();
+    housekeeping.stopThread(-1);
+
+    for (auto& id : ModulationMatrix::getRoutingParameterIDs())
+        parameters.removeParameterListener(id, this);
+}
+
+void SimpleSynthAudioProcessor::applyProgram(const PresetBank::Program& program)
+{
+    // Values were normalised when the bank was loaded; nothing here allocates or locks
+    auto& params = getParameters();
+    const int numValues = juce::jmin((int) program.values.size(), params.size());
+
+    for (int i = 0; i < numValues; ++i)
+        if (!std::isnan(program.values[(size_t) i]))
+            params[i]->setValue(program.values[(size_t) i]);
+
+    parameterNotificationPending.store(true, std::memory_order_release);
 }
 
-void SimpleSynthAudioProcessor::updateParameters()
+void SimpleSynthAudioProcessor::timerCallback()
 {
-    // Update audio processing state based on parameters
-    if (frequencyParam)
-        currentFrequency = frequencyParam->get();
+    if (!parameterNotificationPending.exchange(false, std::memory_order_acquire))
+        return;
+
+    for (auto* param : getParameters())
+        param->sendValueChangedMessageToListeners(param->getValue());
 }
 
-void SimpleSynthAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+void SimpleSynthAudioProcessor::parameterChanged(const juce::String&, float)
 {
-    this->sampleRate = (float)sampleRate;
-    phase = 0.0f;
+    // A routing changed. Automation can arrive on the audio thread, which must
+    // not allocate or lock, so the housekeeping thread compiles the change. Only
+    // the message thread wakes it; from anywhere else it waits for the next pass.
+    modulationChanged.store(true, std::memory_order_release);
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        housekeeping.notify();
 }
 
-void SimpleSynthAudioProcessor::releaseResources()
+void SimpleSynthAudioProcessor::rebuildModulation()
 {
+    modulation.publish(ModulationMatrix::compile(parameters));
 }
 
-void SimpleSynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void SimpleSynthAudioProcessor::runHousekeeping()
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    // Objects the audio thread has replaced are deleted here, never in processBlock
+    tuning.collectGarbage();
+    modulation.collectGarbage();
+    convolution.collectGarbage();
+
+    if (modulationChanged.exchange(false, std::memory_order_acquire))
+        rebuildModulation();
+}
+
+std::unique_ptr<Tuning> SimpleSynthAudioProcessor::createStartupTuning()
+{
+    const auto scaleFile = Tuning::getDefaultScaleFile();
+    if (scaleFile == juce::File())
+        return std::make_unique<Tuning>();
+
+    juce::String error;
+    if (auto loaded = Tuning::loadFromFiles(scaleFile, Tuning::getDefaultKeyboardMapFile(), error))
+        return loaded;
+
+    juce::Logger::writeToLog("SimpleSynth: tuning: " + error);
+    return std::make_unique<Tuning>();
+}
+
+void SimpleSynthAudioProcessor::setTuning(std::unique_ptr<Tuning> newTuning)
+{
+    tuningScaleText = newTuning->getScaleText();
+    tuningKeyboardMapText = newTuning->getKeyboardMapText();
+
+    tuning.publish(std::move(newTuning));
+}
+
+void SimpleSynthAudioProcessor::loadStartupImpulseResponse()
+{
+    const auto file = getDefaultImpulseResponseFile();
+    if (file == juce::File())
+        return;
+
+    juce::String error;
+    if (!loadImpulseResponse(file, error))
+        juce::Logger::writeToLog("SimpleSynth: impulse response: " + error);
+}
 
-    // Update parameter state
-    updateParameters();
+bool SimpleSynthAudioProcessor::loadImpulseResponse(const juce::File& file, juce::String& error)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        error = "cannot read " + file.getFullPathName();
+        return false;
+    }
+
+    const auto maxLength = (juce::int64) (ConvolutionReverb::maxImpulseSeconds * reader->sampleRate);
+    const int length = (int) juce::jmin(reader->lengthInSamples, maxLength);
+
+    juce::AudioBuffer<float> samples((int) juce::jmin(2u, reader->numChannels), length);
+    reader->read(&samples, 0, length, 0, true, true);
+
+    return setImpulseResponse(std::move(samples), reader->sampleRate, file.getFileName(), error);
+}
+
+bool SimpleSynthAudioProcessor::setImpulseResponse(juce::AudioBuffer<float> samples, double rate,
+                                                   const juce::String& name, juce::String& error)
+{
+    auto engine = ConvolutionReverb::Engine::create(samples, rate, sampleRate);
+    if (engine == nullptr)
+    {
+        error = name + " is empty or silent";
+        return false;
+    }
+
+    impulseResponse = std::move(samples);
+    impulseResponseRate = rate;
+    impulseResponseName = name;
+
+    convolution.setEngine(std::move(engine));
+    return true;
+}
+
+bool SimpleSynthAudioProcessor::restoreImpulseResponse(const juce::ValueTree& state, juce::String& error)
+{
+    // States saved before the samples were embedded only have the file's path
+    const auto* data = state["samples"].getBinaryData();
+    if (data == nullptr)
+        return loadImpulseResponse(juce::File(state["file"].toString()), error);
+
+    const int numChannels = state["numChannels"];
+    const double rate = state["sampleRate"];
+    const auto channelBytes = numChannels > 0 ? data->getSize() / (size_t) numChannels : 0;
+
+    if (!juce::isPositiveAndNotGreaterThan(numChannels, 2) || rate <= 0.0
+        || channelBytes == 0 || channelBytes % sizeof(float) != 0 || channelBytes * (size_t) numChannels != data->getSize()
+        || channelBytes / sizeof(float) > (size_t) (ConvolutionReverb::maxImpulseSeconds * rate) + 1)
+    {
+        error = "embedded response is malformed";
+        return false;
+    }
+
+    const int length = (int) (channelBytes / sizeof(float));
+    juce::AudioBuffer<float> samples(numChannels, length);
+    for (int ch = 0; ch < numChannels; ++ch)
+        data->copyTo(samples.getWritePointer(ch), (int) (ch * channelBytes), channelBytes);
+
+    return setImpulseResponse(std::move(samples), rate, state["name"].toString(), error);
+}
+
+void SimpleSynthAudioProcessor::clearImpulseResponse()
+{
+    impulseResponse.setSize(0, 0);
+    impulseResponseRate = 0.0;
+    impulseResponseName.clear();
+
+    convolution.setEngine(std::make_unique<ConvolutionReverb::Engine>());
+}
+
+void SimpleSynthAudioProcessor::updateNoteIncrements()
+{
+    for (int note = 0; note < Tuning::numNotes; ++note)
+        noteIncrements[(size_t) note] = (float) (tuning.get()->getFrequency(note) / sampleRate);
+}
+
+void SimpleSynthAudioProcessor::publishTelemetry(const juce::AudioBuffer<float>& buffer, juce::int64 startTicks)
+{
+    auto& frame = telemetryFrame;
+    const int numSamples = buffer.getNumSamples();
+
+    scopeRing.push(buffer.getReadPointer(0), numSamples);
+
+    frame.blockCounter++;
+    frame.audioThreadAllocations = AudioThreadGuard::getAllocationCount();
+    frame.activeVoices = 0;
+    for (int i = 0; i < maxVoices; ++i)
+    {
+        const auto& voice = voices[(size_t) i];
+        frame.voiceLevels[i] = voice.isActive() ? voice.getEnvelope() : 0.0f;
+        if (voice.isActive())
+            ++frame.activeVoices;
+    }
+
+    // Decimate channel 0 to at most waveformPoints values
+    const int step = juce::jmax(1, (numSamples + TelemetryFrame::waveformPoints - 1) / TelemetryFrame::waveformPoints);
+    const auto* samples = buffer.getReadPointer(0);
+    frame.numWaveformPoints = 0;
+    for (int i = 0; i < numSamples && frame.numWaveformPoints < TelemetryFrame::waveformPoints; i += step)
+        frame.waveform[frame.numWaveformPoints++] = samples[i];
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    frame.blockMicroseconds = (float) (seconds * 1.0e6);
+    frame.blockLoad = numSamples > 0 ? (float) (seconds * sampleRate / numSamples) : 0.0f;
 
-    // Process MIDI
-    for (auto metadata : midiMessages)
+    telemetry.write(frame);
+}
+
+void SimpleSynthAudioProcessor::handleMidiMessage(const juce::MidiMessage& msg)
+{
+    const int channel = msg.getChannel();
+
+    if (msg.isNoteOn())
     {
-        auto msg = metadata.getMessage();
-        if (msg.isNoteOn())
+        startNote(channel, msg.getNoteNumber(), msg.getFloatVelocity());
+    }
+    else if (msg.isNoteOff())
+    {
+        releaseNote(channel, msg.getNoteNumber());
+    }
+    else if (msg.isPitchWheel())
+    {
+        channels[(size_t) channel].pitchBend = juce::jlimit(-1.0f, 1.0f, (float) (msg.getPitchWheelValue() - 8192) / 8191.0f);
+    }
+    else if (msg.isChannelPressure())
+    {
+        channels[(size_t) channel].pressure = (float) msg.getChannelPressureValue() / 127.0f;
+    }
+    else if (msg.isAftertouch())
+    {
+        for (auto& voice : voices)
+            if (voice.isGateOn() && voice.getChannel() == channel && voice.getNote() == msg.getNoteNumber())
+                voice.setPolyPressure((float) msg.getAfterTouchValue() / 127.0f);
+    }
+    else if (msg.isController())
+    {
+        handleController(msg.getChannel(), msg.getControllerNumber(), msg.getControllerValue());
+    }
+    else if (msg.isProgramChange())
+    {
+        const int program = msg.getProgramChangeNumber();
+        if (program < presetBank->size())
         {
-            currentFrequency = juce::MidiMessage::getMidiNoteInHertz(msg.getNoteNumber());
-            noteOn = true;
-            envelope = 0.0f;
+            currentProgram.store(program, std::memory_order_relaxed);
+            applyProgram(presetBank->getProgram(program));
         }
-        else if (msg.isNoteOff())
+    }
+}
+
+void SimpleSynthAudioProcessor::handleController(int channel, int controller, int value)
+{
+    switch (controller)
+    {
+        case 1:   // Mod wheel and MPE timbre are modulation sources; they can be mapped as well
+            channels[(size_t) channel].modWheel = (float) value / 127.0f;
+            break;
+
+        case 74:
+            channels[(size_t) channel].timbre = (float) value / 127.0f;
+            break;
+
+        case 64:  // Sustain pedal
+            channels[(size_t) channel].sustain = value >= 64;
+            if (value < 64)
+                releaseSustainedNotes(channel);
+            return;
+
+        case 120:  // All sound off: silence now, no release
+            forgetHeldNotes(channel);
+            for (auto& voice : voices)
+                if (isMpeMasterChannel(channel) || voice.getChannel() == channel)
+                    voice.kill();
+            return;
+
+        case 123:  // All notes off: release, ignoring the pedal
+            forgetHeldNotes(channel);
+            for (auto& voice : voices)
+                if (voice.isGateOn() && (isMpeMasterChannel(channel) || voice.getChannel() == channel))
+                    voice.release();
+            return;
+
+        default:
+            break;
+    }
+
+    int parameterIndex = controllerMap.learn(channel, controller);
+    if (parameterIndex == MidiControllerMap::unmapped)
+        parameterIndex = controllerMap.getParameterFor(channel, controller);
+
+    if (auto* param = getParameters()[parameterIndex])
+    {
+        param->setValue((float) value / 127.0f);
+        parameterNotificationPending.store(true, std::memory_order_release);
+    }
+}
+
+void SimpleSynthAudioProcessor::startNote(int channel, int note, float velocity)
+{
+    const float noteIncrement = noteIncrements[(size_t) note];
+    if (noteIncrement <= 0.0f)
+        return;  // Left unmapped by the keyboard mapping
+
+    const bool legato = numHeldNotes > 0;
+    addHeldNote(channel, note, velocity);
+
+    const int playMode = playModeParam->getIndex();
+    const int glideSamples = getGlideSamples(legato);
+
+    if (playMode == poly)
+    {
+        auto& voice = allocateVoice(channel, note);
+        voice.start(channel, note, noteIncrement, velocity, ++noteCounter,
+                    getBendSemitones(channel), getPressure(channel));
+        voice.glideFrom(lastNoteIncrement, glideSamples);
+    }
+    else
+    {
+        // Mono modes always play voice 0, gliding from wherever it is now
+        auto& voice = voices[0];
+        const float fromIncrement = voice.isActive() ? voice.getPitchIncrement() : lastNoteIncrement;
+
+        if (playMode == monoLegato && legato && voice.isGateOn())
+            voice.legatoTo(channel, note, noteIncrement, velocity);
+        else
+            voice.start(channel, note, noteIncrement, velocity, ++noteCounter,
+                        getBendSemitones(channel), getPressure(channel));
+
+        voice.glideFrom(fromIncrement, glideSamples);
+    }
+
+    lastNoteIncrement = noteIncrement;
+}
+
+void SimpleSynthAudioProcessor::releaseNote(int channel, int note)
+{
+    removeHeldNote(channel, note);
+
+    // Mono modes: releasing the sounding key goes back to the newest key still held
+    auto& monoVoice = voices[0];
+    const int playMode = playModeParam->getIndex();
+
+    if (playMode != poly && numHeldNotes > 0 && monoVoice.isPlaying(channel, note))
+    {
+        const auto held = heldNotes[(size_t) (numHeldNotes - 1)];
+        const float noteIncrement = noteIncrements[(size_t) held.note];
+        const float fromIncrement = monoVoice.getPitchIncrement();
+
+        if (playMode == monoLegato)
+            monoVoice.legatoTo(held.channel, held.note, noteIncrement, held.velocity);
+        else
+            monoVoice.start(held.channel, held.note, noteIncrement, held.velocity, ++noteCounter,
+                            getBendSemitones(held.channel), getPressure(held.channel));
+
+        monoVoice.glideFrom(fromIncrement, getGlideSamples(true));
+        lastNoteIncrement = noteIncrement;
+        return;
+    }
+
+    for (auto& voice : voices)
+    {
+        if (!voice.isPlaying(channel, note))
+            continue;
+
+        if (isSustained(channel))
+            voice.setSustained();
+        else
+            voice.release();
+    }
+}
+
+void SimpleSynthAudioProcessor::addHeldNote(int channel, int note, float velocity)
+{
+    removeHeldNote(channel, note);
+
+    if (numHeldNotes == (int) heldNotes.size())
+        removeHeldNote(heldNotes[0].channel, heldNotes[0].note);
+
+    heldNotes[(size_t) numHeldNotes++] = { channel, note, velocity };
+}
+
+void SimpleSynthAudioProcessor::removeHeldNote(int channel, int note)
+{
+    for (int i = 0; i < numHeldNotes; ++i)
+    {
+        if (heldNotes[(size_t) i].channel == channel && heldNotes[(size_t) i].note == note)
         {
-            noteOn = false;
+            std::copy(heldNotes.begin() + i + 1, heldNotes.begin() + numHeldNotes, heldNotes.begin() + i);
+            --numHeldNotes;
+            return;
         }
     }
+}
+
+void SimpleSynthAudioProcessor::forgetHeldNotes(int channel)
+{
+    for (int i = numHeldNotes; --i >= 0;)
+        if (isMpeMasterChannel(channel) || heldNotes[(size_t) i].channel == channel)
+            removeHeldNote(heldNotes[(size_t) i].channel, heldNotes[(size_t) i].note);
+}
+
+int SimpleSynthAudioProcessor::getGlideSamples(bool legato) const noexcept
+{
+    const int glideMode = glideModeParam->getIndex();
+    if (glideMode == glideOff || (glideMode == glideLegato && !legato))
+        return 0;
+
+    return juce::roundToInt(glideTimeParam->get() * sampleRate);
+}
+
+void SimpleSynthAudioProcessor::releaseSustainedNotes(int channel)
+{
+    // In MPE mode the master channel's pedal holds the whole zone
+    for (auto& voice : voices)
+        if (voice.isGateOn() && voice.isSustained()
+            && (isMpeMasterChannel(channel) || voice.getChannel() == channel)
+            && !isSustained(voice.getChannel()))
+            voice.release();
+}
 
-    // Generate audio
-    auto* channelData = buffer.getWritePointer(0);
-    float gain = gainParam ? gainParam->get() : 0.3f;
+bool SimpleSynthAudioProcessor::isSustained(int channel) const noexcept
+{
+    return channels[(size_t) channel].sustain
+        || (mpeParam->get() && channels[(size_t) mpeMasterChannel].sustain);
+}
+
+bool SimpleSynthAudioProcessor::isMpeMasterChannel(int channel) const noexcept
+{
+    return mpeParam->get() && channel == mpeMasterChannel;
+}
 
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+SynthVoice& SimpleSynthAudioProcessor::allocateVoice(int channel, int note)
+{
+    // Same note on the same channel retriggers its voice
+    for (auto& voice : voices)
+        if (voice.isActive() && voice.getChannel() == channel && voice.getNote() == note)
+            return voice;
+
+    for (auto& voice : voices)
+        if (!voice.isActive())
+            return voice;
+
+    // Steal the oldest released voice, or the oldest held one if none are releasing
+    auto* stolen = &voices[0];
+    for (auto& voice : voices)
     {
-        // Simple envelope (attack and release)
-        if (noteOn)
+        if (voice.isGateOn() != stolen->isGateOn())
         {
-            envelope = juce::jmin(envelope + 0.01f, 1.0f); // Attack
+            if (!voice.isGateOn())
+                stolen = &voice;
         }
-        else
+        else if (voice.getStartOrder() < stolen->getStartOrder())
         {
-            envelope = juce::jmax(envelope - 0.02f, 0.0f); // Release
+            stolen = &voice;
         }
+    }
 
-        // Waveform selection
-        float output = 0.0f;
-        int waveform = waveformParam ? waveformParam->getIndex() : 0;
+    return *stolen;
+}
 
-        // Generate selected waveform
-        float phaseIncrement = currentFrequency / sampleRate;
-        phase += phaseIncrement;
-        if (phase > 1.0f) phase -= 1.0f;
+float SimpleSynthAudioProcessor::getBendSemitones(int channel) const noexcept
+{
+    const float range = (float) bendRangeParam->get();
+
+    // MPE member channels bend per note over a wide range, plus the zone-wide master bend
+    if (mpeParam->get() && channel != mpeMasterChannel)
+        return channels[(size_t) channel].pitchBend * (float) mpeMemberBendRange
+             + channels[(size_t) mpeMasterChannel].pitchBend * range;
+
+    return channels[(size_t) channel].pitchBend * range;
+}
 
-        switch (waveform)
+float SimpleSynthAudioProcessor::getPressure(int channel) const noexcept
+{
+    if (mpeParam->get() && channel != mpeMasterChannel)
+        return juce::jmax(channels[(size_t) channel].pressure, channels[(size_t) mpeMasterChannel].pressure);
+
+    return channels[(size_t) channel].pressure;
+}
+
+void SimpleSynthAudioProcessor::updateTransport()
+{
+    transportRunning = false;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
         {
-            case 0: // Sine
-                output = std::sin(phase * juce::MathConstants<float>::twoPi);
-                break;
-            case 1: // Square
-                output = phase < 0.5f ? 1.0f : -1.0f;
-                break;
-            case 2: // Sawtooth
-                output = 2.0f * phase - 1.0f;
-                break;
-            case 3: // Triangle
-                output = phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
-                break;
+            if (auto bpm = position->getBpm())
+            {
+                tempoBpm = *bpm;
+                lastTempoBpm.store(tempoBpm, std::memory_order_relaxed);
+            }
+
+            if (auto ppq = position->getPpqPosition())
+            {
+                blockStartPpq = *ppq;
+                transportRunning = position->getIsPlaying();
+            }
         }
+    }
+}
+
+void SimpleSynthAudioProcessor::applyLfos(SynthVoice::BlockParameters& block, int endSample, int numSamples)
+{
+    const double beatsPerSample = tempoBpm / (60.0 * sampleRate);
+
+    for (int i = 0; i < numLfos; ++i)
+    {
+        const auto& params = lfoParams[(size_t) i];
+        auto& lfo = lfos[(size_t) i];
+
+        // Synced LFOs lock to the host position while the transport runs and
+        // free-run at the synced rate while it is stopped
+        if (params.sync->get())
+        {
+            const double cycleBeats = noteDivisionBeats[params.division->getIndex()];
+            if (transportRunning)
+                lfo.sync((blockStartPpq + endSample * beatsPerSample) / cycleBeats);
+            else
+                lfo.advance(numSamples * beatsPerSample / cycleBeats);
+        }
+        else
+        {
+            lfo.advance(numSamples * (double) params.rate->get() / sampleRate);
+        }
+
+        const float amount = params.amount->get();
+        lfoValues[(size_t) i] = lfo.getValue((Lfo::Shape) params.shape->getIndex());
+        const float value = lfoValues[(size_t) i] * amount;
 
-        output *= envelope * gain;
-        channelData[sample] = output;
+        switch (params.destination->getIndex())
+        {
+            case lfoPitch:  block.pitchSemitones += value * lfoPitchSemitones; break;
+            case lfoCutoff: block.cutoffOctaves += value * lfoCutoffOctaves; break;
+            case lfoPan:    block.panOffset += value; break;
+
+            // Tremolo only ever turns down: between full level and 1 - |amount|
+            case lfoGain:   block.gainFactor *= 1.0f - 0.5f * (std::abs(amount) - value); break;
+
+            default:        break;
+        }
     }
+}
+
+void SimpleSynthAudioProcessor::renderVoices(float* left, float* right, int startSample, int numSamples)
+{
+    // Control rate: parameters, LFOs and channel expression are read once per sub-block
+    SynthVoice::BlockParameters block;
+    block.waveform = (SynthVoice::Waveform) waveformParam->getIndex();
+    block.pitchScale = frequencyParam->get() / 440.0f;
+    block.gain = gainParam->get();
+    block.cutoff = cutoffParam->get();
+    block.pan = panParam->get();
+    applyLfos(block, startSample + numSamples, numSamples);
 
-    // Copy to stereo
-    if (getTotalNumOutputChannels() > 1)
+    const auto* program = modulation.get();
+
+    ModulationMatrix::SourceValues sources {};
+    sources[ModulationMatrix::lfo1] = lfoValues[0];
+    sources[ModulationMatrix::lfo2] = lfoValues[1];
+
+    ModulationMatrix::DestinationValues shared {};
+    program->evaluateShared(sources, shared);
+    applyModulation(shared, block);
+
+    const bool mpe = mpeParam->get();
+
+    for (auto& voice : voices)
     {
-        auto* rightChannel = buffer.getWritePointer(1);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        if (!voice.isActive())
+            continue;
+
+        const int channel = voice.getChannel();
+        const float channelPressure = getPressure(channel);
+        voice.setExpression(getBendSemitones(channel), channelPressure);
+
+        if (!program->hasPerVoiceRoutings())
         {
-            rightChannel[sample] = channelData[sample];
+            voice.render(left + startSample, right + startSample, numSamples, block);
+            continue;
         }
+
+        // The mod wheel on the MPE master channel reaches every member channel
+        const auto& state = channels[(size_t) channel];
+        float wheel = state.modWheel;
+        if (mpe && channel != mpeMasterChannel)
+            wheel = juce::jmax(wheel, channels[(size_t) mpeMasterChannel].modWheel);
+
+        sources[ModulationMatrix::envelope] = voice.getEnvelope();
+        sources[ModulationMatrix::velocity] = voice.getVelocity();
+        sources[ModulationMatrix::key] = (float) (voice.getNote() - 60) / 60.0f;
+        sources[ModulationMatrix::pressure] = juce::jmax(channelPressure, voice.getPolyPressure());
+        sources[ModulationMatrix::timbre] = state.timbre;
+        sources[ModulationMatrix::modWheel] = wheel;
+
+        ModulationMatrix::DestinationValues perVoice {};
+        program->evaluatePerVoice(sources, perVoice);
+
+        auto voiceBlock = block;
+        applyModulation(perVoice, voiceBlock);
+        voice.render(left + startSample, right + startSample, numSamples, voiceBlock);
+    }
+}
+
+void SimpleSynthAudioProcessor::applyDelay(float* left, float* right, int numSamples)
+{
+    if (!delayParams.enabled->get())
+    {
+        delayRunning = false;
+        return;
+    }
+
+    if (!delayRunning)
+        delay.reset();
+    delayRunning = true;
+
+    const double seconds = delayParams.sync->get() ? getSyncedDelaySeconds(tempoBpm)
+                                                   : delayParams.time->get() / 1000.0;
+
+    StereoDelay::Settings settings;
+    settings.delaySamples = juce::roundToInt(seconds * sampleRate);
+    settings.feedback = delayParams.feedback->get();
+    settings.mix = delayParams.mix->get();
+    settings.pingPong = delayParams.pingPong->get();
+
+    const float damping = delayParams.damping->get();
+    settings.dampingCoefficient = damping < SynthVoice::openCutoff ? delay.getDampingCoefficient(damping) : 1.0f;
+
+    delay.process(left, right, numSamples, settings);
+}
+
+void SimpleSynthAudioProcessor::applyReverb(float* left, float* right, int numSamples)
+{
+    if (!reverbParams.enabled->get())
+    {
+        reverbRunning = false;
+        return;
+    }
+
+    if (!reverbRunning)
+        reverb.reset();
+    reverbRunning = true;
+
+    FdnReverb::Settings settings;
+    settings.decaySeconds = reverbParams.decay->get();
+    settings.mix = reverbParams.mix->get();
+
+    const float damping = reverbParams.damping->get();
+    settings.dampingCoefficient = damping < SynthVoice::openCutoff ? reverb.getDampingCoefficient(damping) : 1.0f;
+
+    reverb.process(left, right, numSamples, settings);
+}
+
+void SimpleSynthAudioProcessor::applyConvolution(float* left, float* right, int numSamples)
+{
+    if (!convolutionParam->get())
+    {
+        convolutionRunning = false;
+        return;
+    }
+
+    if (!convolutionRunning)
+        convolution.reset();
+    convolutionRunning = true;
+
+    convolution.process(left, right, numSamples, convolutionMixParam->get(), isNonRealtime());
+}
+
+juce::String SimpleSynthAudioProcessor::getLfoParameterID(int lfo, const char* name)
+{
+    return "lfo" + juce::String(lfo + 1) + name;
+}
+
+void SimpleSynthAudioProcessor::resetControllerMap()
+{
+    // Defaults: CC7 (channel volume) drives Gain on every channel
+    controllerMap.clear();
+    controllerMap.map(0, 7, gainParam->getParameterIndex());
+}
+
+void SimpleSynthAudioProcessor::handleNoteOn(juce::MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity)
+{
+    keyboardQueue.push(juce::MidiMessage::noteOn(midiChannel, midiNoteNumber, velocity));
+}
+
+void SimpleSynthAudioProcessor::handleNoteOff(juce::MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity)
+{
+    keyboardQueue.push(juce::MidiMessage::noteOff(midiChannel, midiNoteNumber, velocity));
+}
+
+void SimpleSynthAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    // Audio is stopped, so catch up here and restart the thread at the end
+    housekeeping.stopThread(-1);
+    runHousekeeping();
+
+    this->sampleRate = (float)sampleRate;
+
+    for (auto& voice : voices)
+        voice.prepare(sampleRate);
+
+    delay.prepare(sampleRate, samplesPerBlock);
+    reverb.prepare(sampleRate);
+
+    // Responses are resampled when the engine is built, so rebuild at the new rate
+    if (impulseResponse.getNumSamples() > 0)
+        convolution.setEngine(ConvolutionReverb::Engine::create(impulseResponse, impulseResponseRate, sampleRate));
+    convolution.prepare();
+
+    tuning.adopt();
+    updateNoteIncrements();
+    modulation.adopt();
+    reset();
+
+    housekeeping.startThread(juce::Thread::Priority::low);
+}
+
+void SimpleSynthAudioProcessor::releaseResources()
+{
+    housekeeping.stopThread(-1);
+
+    if (AudioThreadGuard::isEnabled())
+        juce::Logger::writeToLog("SimpleSynth: audio-thread allocations: "
+                                 + juce::String((juce::int64) AudioThreadGuard::getAllocationCount()));
+
+    if (const int late = convolution.getNumLateTailBlocks(); late > 0)
+        juce::Logger::writeToLog("SimpleSynth: convolution tail blocks dropped: " + juce::String(late));
+}
+
+void SimpleSynthAudioProcessor::reset()
+{
+    // Silence all voices immediately (used on prepare and by the host's reset command)
+    for (auto& voice : voices)
+        voice.kill();
+
+    channels.fill({});
+    numHeldNotes = 0;
+    lastNoteIncrement = 0.0f;
+
+    for (auto& lfo : lfos)
+        lfo.reset();
+
+    delay.reset();
+    reverb.reset();
+    convolution.reset();
+}
+
+void SimpleSynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    AudioThreadGuard::ScopedAudioThread audioThread;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const int numSamples = buffer.getNumSamples();
+
+    if (auto* program = pendingProgram.exchange(nullptr, std::memory_order_acquire))
+        applyProgram(*program);
+
+    if (tuning.adopt())
+        updateNoteIncrements();
+
+    modulation.adopt();
+    updateTransport();
+    buffer.clear();
+
+    // On-screen keyboard events land at the start of the block
+    keyboardQueue.popAll([this](const juce::MidiMessage& msg) { handleMidiMessage(msg); });
+
+    // Render sample-accurately: voices run in sub-blocks of at most
+    // controlBlockSize samples, split wherever a MIDI event falls. A mono
+    // output gets both sides summed into it and halved below.
+    const bool stereo = buffer.getNumChannels() > 1;
+    auto* left = buffer.getWritePointer(0);
+    auto* right = stereo ? buffer.getWritePointer(1) : left;
+    auto event = midiMessages.cbegin();
+    const auto lastEvent = midiMessages.cend();
+    int position = 0;
+
+    while (position < numSamples)
+    {
+        for (; event != lastEvent && (*event).samplePosition <= position; ++event)
+            handleMidiMessage((*event).getMessage());
+
+        const int nextEvent = event != lastEvent ? (*event).samplePosition : numSamples;
+        const int end = juce::jmin(nextEvent, numSamples, position + SynthVoice::controlBlockSize);
+
+        renderVoices(left, right, position, end - position);
+        position = end;
     }
+
+    for (; event != lastEvent; ++event)
+        handleMidiMessage((*event).getMessage());
+
+    applyDelay(left, right, numSamples);
+    applyReverb(left, right, numSamples);
+    applyConvolution(left, right, numSamples);
+
+    if (!stereo)
+        buffer.applyGain(0.5f);
+
+    publishTelemetry(buffer, startTicks);
 }
 
 juce::AudioProcessorEditor* SimpleSynthAudioProcessor::createEditor()
@@ -147,28 +931,68 @@ bool SimpleSynthAudioProcessor::isMidiEffect() const
     return false;
 }
 
+double SimpleSynthAudioProcessor::getSyncedDelaySeconds(double bpm) const noexcept
+{
+    // Capped like the line itself; only "1/2" below 60 BPM and "1/4 Dotted"
+    // below 45 BPM reach the cap
+    const double beats = noteDivisionBeats[firstDelayDivision + delayParams.division->getIndex()];
+    return juce::jmin(StereoDelay::maxDelaySeconds, beats * 60.0 / bpm);
+}
+
 double SimpleSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The effects are in series, so their tails add up
+    double tail = 0.0;
+
+    if (delayParams.enabled->get())
+    {
+        // Synced times use the latest host tempo
+        const double delaySeconds = delayParams.sync->get()
+                                        ? getSyncedDelaySeconds(lastTempoBpm.load(std::memory_order_relaxed))
+                                        : delayParams.time->get() / 1000.0;
+
+        // Repeats until the echoes have fallen by 60 dB
+        const double feedback = delayParams.feedback->get();
+        const double repeats = feedback > 0.001 ? std::ceil(std::log(0.001) / std::log(feedback)) : 1.0;
+
+        tail += delaySeconds * repeats;
+    }
+
+    // The decay time is the 60 dB point; the last sound in the lines still has one trip to make
+    if (reverbParams.enabled->get())
+        tail += reverbParams.decay->get() + FdnReverb::maxLineSeconds;
+
+    if (convolutionParam->get() && impulseResponseRate > 0.0)
+        tail += juce::jmin(impulseResponse.getNumSamples() / impulseResponseRate, ConvolutionReverb::maxImpulseSeconds);
+
+    return tail;
 }
 
 int SimpleSynthAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return presetBank->size();
 }
 
 int SimpleSynthAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load(std::memory_order_relaxed);
 }
 
 void SimpleSynthAudioProcessor::setCurrentProgram(int index)
 {
+    if (!juce::isPositiveAndBelow(index, presetBank->size()))
+        return;
+
+    currentProgram.store(index, std::memory_order_relaxed);
+    pendingProgram.store(&presetBank->getProgram(index), std::memory_order_release);
 }
 
 const juce::String SimpleSynthAudioProcessor::getProgramName(int index)
 {
-    return {};
+    if (!juce::isPositiveAndBelow(index, presetBank->size()))
+        return {};
+
+    return presetBank->getProgram(index).name;
 }
 
 void SimpleSynthAudioProcessor::changeProgramName(int index, const juce::String& newName)
@@ -177,20 +1001,115 @@ void SimpleSynthAudioProcessor::changeProgramName(int index, const juce::String&
 
 void SimpleSynthAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto xml = parameters.state.createXml();
-    if (xml)
+    // Header + binary ValueTree: much cheaper to recall than the XML text used previously
+    juce::MemoryOutputStream out(destData, true);
+    out.writeInt((int) stateMagic);
+    out.writeInt(stateVersion);
+
+    auto state = parameters.copyState();
+    state.removeChild(state.getChildWithName(MidiControllerMap::treeType), nullptr);
+    state.appendChild(controllerMap.toValueTree(*this), nullptr);
+
+    // Always written, so a 12-TET session reloads as 12-TET rather than as whatever
+    // $SIMPLESYNTH_TUNING points at
+    state.removeChild(state.getChildWithName(tuningType), nullptr);
+    if (tuningScaleText.isNotEmpty())
+        state.appendChild(juce::ValueTree(tuningType, { { "scale", tuningScaleText },
+                                                        { "keyboardMap", tuningKeyboardMapText } }), nullptr);
+    else
+        state.appendChild(juce::ValueTree(tuningType, { { "equalTemperament", true } }), nullptr);
+
+    // The samples travel with the state, so a session recalls its response on
+    // any machine, wherever (or whether) the file still exists. Channels are
+    // stored one after another as native-endian floats.
+    state.removeChild(state.getChildWithName(impulseResponseType), nullptr);
+    if (impulseResponse.getNumSamples() > 0)
     {
-        juce::String xmlString = xml->toString();
-        destData.append(xmlString.toUTF8(), xmlString.getNumBytesAsUTF8());
+        juce::MemoryBlock samples;
+        for (int ch = 0; ch < impulseResponse.getNumChannels(); ++ch)
+            samples.append(impulseResponse.getReadPointer(ch), (size_t) impulseResponse.getNumSamples() * sizeof(float));
+
+        state.appendChild(juce::ValueTree(impulseResponseType, { { "name", impulseResponseName },
+                                                                 { "sampleRate", impulseResponseRate },
+                                                                 { "numChannels", impulseResponse.getNumChannels() },
+                                                                 { "samples", samples } }), nullptr);
     }
+
+    state.writeToStream(out);
 }
 
 void SimpleSynthAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    if (data && sizeInBytes > 0)
+    if (data == nullptr || sizeInBytes <= 0)
+        return;
+
+    juce::ValueTree state;
+
+    if (sizeInBytes >= stateHeaderSize
+        && (juce::uint32) juce::ByteOrder::littleEndianInt(data) == stateMagic)
+    {
+        juce::MemoryInputStream in(data, (size_t) sizeInBytes, false);
+        in.skipNextBytes(4);
+
+        // Later versions must keep the ValueTree first and append anything new after it
+        if (in.readInt() < 1)
+            return;
+
+        state = juce::ValueTree::readFromStream(in);
+    }
+    else
+    {
+        // Older builds stored the state as an XML string
+        state = juce::ValueTree::fromXml(juce::String::fromUTF8(static_cast<const char*>(data), sizeInBytes));
+    }
+
+    if (!state.hasType(parameters.state.getType()))
+        return;
+
+    // States saved before CC mapping existed get the default bindings
+    auto ccMap = state.getChildWithName(MidiControllerMap::treeType);
+    if (ccMap.isValid())
+        controllerMap.fromValueTree(ccMap, *this);
+    else
+        resetControllerMap();
+
+    // The Scala text travels with the state. States saved before the 12-TET marker
+    // existed have no TUNING child for 12-TET; they fall back to the startup tuning.
+    auto tuningState = state.getChildWithName(tuningType);
+    if (tuningState.getProperty("equalTemperament", false))
+    {
+        setTuning(std::make_unique<Tuning>());
+    }
+    else if (tuningState.isValid())
+    {
+        juce::String error;
+        if (auto loaded = Tuning::fromScala(tuningState["scale"], tuningState["keyboardMap"], error))
+            setTuning(std::move(loaded));
+        else
+            juce::Logger::writeToLog("SimpleSynth: tuning in saved state: " + error);
+    }
+    else
+    {
+        setTuning(createStartupTuning());
+    }
+
+    auto impulseResponseState = state.getChildWithName(impulseResponseType);
+    if (impulseResponseState.isValid())
     {
-        parameters.replaceState(juce::ValueTree::fromXml(juce::String::fromUTF8(static_cast<const char*>(data), sizeInBytes)));
+        juce::String error;
+        if (!restoreImpulseResponse(impulseResponseState, error))
+            juce::Logger::writeToLog("SimpleSynth: impulse response in saved state: " + error);
     }
+    else if (getDefaultImpulseResponseFile() == juce::File())
+    {
+        clearImpulseResponse();
+    }
+    else
+    {
+        loadStartupImpulseResponse();
+    }
+
+    parameters.replaceState(state);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SimpleSynthAudioProcessor::createParameterLayout()
@@ -219,6 +1138,195 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleSynthAudioProcessor::c
         0
     ));
 
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID(ID::bendRange, 1),
+        "Bend Range",
+        0, 48,
+        2
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::mpe, 1),
+        "MPE",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ID::playMode, 1),
+        "Play Mode",
+        juce::StringArray{"Poly", "Mono", "Mono Legato"},
+        0
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ID::glideMode, 1),
+        "Glide",
+        juce::StringArray{"Off", "Always", "Legato"},
+        0
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::glideTime, 1),
+        "Glide Time",
+        juce::NormalisableRange<float>(0.0f, 2.0f, 0.001f, 0.4f),
+        0.1f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::cutoff, 1),
+        "Cutoff",
+        juce::NormalisableRange<float>(20.0f, SynthVoice::openCutoff, 1.0f, 0.25f),
+        SynthVoice::openCutoff
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::pan, 1),
+        "Pan",
+        juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::delay, 1),
+        "Delay",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::delayTime, 1),
+        "Delay Time",
+        juce::NormalisableRange<float>(1.0f, (float) StereoDelay::maxDelaySeconds * 1000.0f, 1.0f, 0.4f),
+        350.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::delaySync, 1),
+        "Delay Sync",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ID::delayDivision, 1),
+        "Delay Division",
+        juce::StringArray(noteDivisionNames.begin() + firstDelayDivision, noteDivisionNames.size() - firstDelayDivision),
+        noteDivisionNames.indexOf("1/8 Dotted") - firstDelayDivision
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::delayFeedback, 1),
+        "Delay Feedback",
+        juce::NormalisableRange<float>(0.0f, 0.95f, 0.001f),
+        0.35f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::delayDamping, 1),
+        "Delay Damping",
+        juce::NormalisableRange<float>(200.0f, SynthVoice::openCutoff, 1.0f, 0.25f),
+        6000.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::delayMix, 1),
+        "Delay Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.3f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::delayPingPong, 1),
+        "Ping Pong",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::reverb, 1),
+        "Reverb",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::reverbDecay, 1),
+        "Reverb Decay",
+        juce::NormalisableRange<float>(0.2f, 20.0f, 0.01f, 0.4f),
+        2.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::reverbDamping, 1),
+        "Reverb Damping",
+        juce::NormalisableRange<float>(200.0f, SynthVoice::openCutoff, 1.0f, 0.25f),
+        8000.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::reverbMix, 1),
+        "Reverb Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.25f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ID::convolution, 1),
+        "Convolution",
+        false
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ID::convolutionMix, 1),
+        "Convolution Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.3f
+    ));
+
+    for (int i = 0; i < numLfos; ++i)
+    {
+        const auto name = "LFO " + juce::String(i + 1) + " ";
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(getLfoParameterID(i, "Shape"), 1),
+            name + "Shape",
+            juce::StringArray{"Sine", "Triangle", "Sawtooth", "Square", "Sample & Hold"},
+            0
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(getLfoParameterID(i, "Rate"), 1),
+            name + "Rate",
+            juce::NormalisableRange<float>(0.01f, 20.0f, 0.01f, 0.3f),
+            5.0f
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID(getLfoParameterID(i, "Sync"), 1),
+            name + "Sync",
+            false
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(getLfoParameterID(i, "Division"), 1),
+            name + "Division",
+            noteDivisionNames,
+            noteDivisionNames.indexOf("1/4")
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(getLfoParameterID(i, "Destination"), 1),
+            name + "Destination",
+            juce::StringArray{"Off", "Pitch", "Gain", "Cutoff", "Pan"},
+            lfoOff
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(getLfoParameterID(i, "Amount"), 1),
+            name + "Amount",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.001f),
+            0.1f
+        ));
+    }
+
+    ModulationMatrix::addParameters(layout);
+
     return layout;
 }
 
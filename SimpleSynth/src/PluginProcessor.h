@@ -1,6 +1,22 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+#include "AudioThreadGuard.h"
+#include "AudioThreadHandoff.h"
+#include "ConvolutionReverb.h"
+#include "FdnReverb.h"
+#include "KeyboardMidiQueue.h"
+#include "Lfo.h"
+#include "MidiControllerMap.h"
+#include "ModulationMatrix.h"
+#include "PresetBank.h"
+#include "StereoDelay.h"
+#include "SynthVoice.h"
+#include "Telemetry.h"
+#include "Tuning.h"
 
 namespace ID
 {
@@ -9,11 +25,35 @@ namespace ID
     PARAMETER_ID (frequency)
     PARAMETER_ID (gain)
     PARAMETER_ID (waveform)
+    PARAMETER_ID (bendRange)
+    PARAMETER_ID (mpe)
+    PARAMETER_ID (playMode)
+    PARAMETER_ID (glideMode)
+    PARAMETER_ID (glideTime)
+    PARAMETER_ID (cutoff)
+    PARAMETER_ID (pan)
+    PARAMETER_ID (delay)
+    PARAMETER_ID (delayTime)
+    PARAMETER_ID (delaySync)
+    PARAMETER_ID (delayDivision)
+    PARAMETER_ID (delayFeedback)
+    PARAMETER_ID (delayDamping)
+    PARAMETER_ID (delayMix)
+    PARAMETER_ID (delayPingPong)
+    PARAMETER_ID (reverb)
+    PARAMETER_ID (reverbDecay)
+    PARAMETER_ID (reverbDamping)
+    PARAMETER_ID (reverbMix)
+    PARAMETER_ID (convolution)
+    PARAMETER_ID (convolutionMix)
 
     #undef PARAMETER_ID
 }
 
-class SimpleSynthAudioProcessor : public juce::AudioProcessor
+class SimpleSynthAudioProcessor : public juce::AudioProcessor,
+                                  private juce::Timer,
+                                  private juce::MidiKeyboardState::Listener,
+                                  private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     SimpleSynthAudioProcessor();
@@ -21,6 +61,7 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
@@ -41,14 +82,135 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    juce::AudioProcessorValueTreeState& getValueTreeState() noexcept { return parameters; }
+
+    // CC -> parameter bindings, including MIDI learn
+    MidiControllerMap& getControllerMap() noexcept { return controllerMap; }
+
+    // State for the editor's on-screen keyboard (message thread only)
+    juce::MidiKeyboardState& getKeyboardState() noexcept { return keyboardState; }
+
+    // Lock-free snapshot of the last processed block, for the editor
+    const SeqLock<TelemetryFrame>& getTelemetry() const noexcept { return telemetry; }
+
+    // Newest output samples (channel 0) for the scope and spectrum views
+    const ScopeRing& getScopeRing() const noexcept { return scopeRing; }
+
+    // Message thread: the new tuning takes effect at the next block
+    void setTuning(std::unique_ptr<Tuning> newTuning);
+
+    // Message thread: reads an impulse response file for the convolution
+    // reverb. It takes effect at the next tail block; on failure the current
+    // response stays.
+    bool loadImpulseResponse(const juce::File& file, juce::String& error);
+    void clearImpulseResponse();
+
+    static constexpr int maxVoices = TelemetryFrame::maxVoices;
+
+    // MPE lower zone: channel 1 is the master channel, 2-16 carry one note each
+    static constexpr int mpeMasterChannel = 1;
+    static constexpr int mpeMemberBendRange = 48;
+
+    // Choice indices of the Play Mode and Glide Mode parameters
+    enum PlayMode { poly, mono, monoLegato };
+    enum GlideMode { glideOff, glideAlways, glideLegato };
+
+    // LFO parameters are "lfo1Shape", "lfo2Rate", ... (see createParameterLayout)
+    static constexpr int numLfos = 2;
+    static_assert(numLfos == ModulationMatrix::lfo2 - ModulationMatrix::lfo1 + 1, "Each LFO is a modulation source");
+    enum LfoDestination { lfoOff, lfoPitch, lfoGain, lfoCutoff, lfoPan };
+
 private:
-    // Audio parameters
+    // Binary state header: "SSYN" magic, then a format version
+    static constexpr juce::uint32 stateMagic = 0x4e595353;
+    static constexpr int stateVersion = 1;
+    static constexpr int stateHeaderSize = 8;
+    static inline const juce::Identifier tuningType { "TUNING" };
+    static inline const juce::Identifier impulseResponseType { "IMPULSE_RESPONSE" };
+
+    // Per-channel expression as last received; voices read it once per sub-block
+    struct ChannelState
+    {
+        float pitchBend = 0.0f;     // -1..1
+        float pressure = 0.0f;      // 0..1
+        float modWheel = 0.0f;      // CC1, 0..1
+        float timbre = 0.0f;        // CC74 (MPE timbre), 0..1
+        bool sustain = false;       // CC64 held
+    };
+
     // Audio processing state
-    float phase = 0.0f;
-    float currentFrequency = 440.0f;
     float sampleRate = 44100.0f;
-    float envelope = 0.0f;
-    bool noteOn = false;
+    std::array<SynthVoice, maxVoices> voices;
+    std::array<ChannelState, 17> channels;      // Indexed by MIDI channel 1-16
+    juce::uint32 noteCounter = 0;               // Voice start order, for stealing
+
+    // Keys physically down, oldest first: mono modes fall back to the newest
+    // remaining one on release, and legato glide needs to know if any is held
+    struct HeldNote { int channel; int note; float velocity; };
+    std::array<HeldNote, 128> heldNotes {};
+    int numHeldNotes = 0;
+    float lastNoteIncrement = 0.0f;             // Where the next glide starts from
+
+    // LFOs and the host tempo they sync to, read from the play head once per block
+    std::array<Lfo, numLfos> lfos;
+    std::array<float, numLfos> lfoValues {};    // Latest raw values, for the modulation matrix
+    double tempoBpm = 120.0;
+    std::atomic<double> lastTempoBpm { 120.0 };  // Copy of tempoBpm for getTailLengthSeconds()
+    double blockStartPpq = 0.0;
+    bool transportRunning = false;
+
+    // Tuning: published by setTuning(), adopted at a block boundary.
+    // noteIncrements is the active table at the current sample rate, rebuilt
+    // only when either changes.
+    AudioThreadHandoff<Tuning> tuning;
+    std::array<float, Tuning::numNotes> noteIncrements {};
+    juce::String tuningScaleText, tuningKeyboardMapText;  // Message-thread copy, for the state
+
+    // Compiled modulation matrix, rebuilt by the housekeeping thread when a routing changes
+    AudioThreadHandoff<ModulationMatrix::Program> modulation;
+    std::atomic<bool> modulationChanged { false };
+
+    // Deletes what the audio thread has replaced and compiles routing changes.
+    // A thread rather than the timer, so it also runs in hosts that never pump
+    // a message loop. It runs from prepareToPlay() to releaseResources().
+    class HousekeepingThread : public juce::Thread
+    {
+    public:
+        static constexpr int intervalMs = 30;
+
+        explicit HousekeepingThread(SimpleSynthAudioProcessor& ownerProcessor)
+            : Thread("SimpleSynth housekeeping"), owner(ownerProcessor)
+        {
+        }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                owner.runHousekeeping();
+                wait(intervalMs);
+            }
+        }
+
+    private:
+        SimpleSynthAudioProcessor& owner;
+    };
+
+    HousekeepingThread housekeeping { *this };
+
+    // Effects on the voice mix, in this order. Each restarts from silence when switched on.
+    StereoDelay delay;
+    FdnReverb reverb;
+    ConvolutionReverb convolution;
+    bool delayRunning = false;
+    bool reverbRunning = false;
+    bool convolutionRunning = false;
+
+    // Message-thread copy of the loaded impulse response, rebuilt into a
+    // convolution engine whenever the sample rate changes
+    juce::AudioBuffer<float> impulseResponse;
+    double impulseResponseRate = 0.0;
+    juce::String impulseResponseName;   // File name, for messages
 
     // Parameter management
     juce::AudioProcessorValueTreeState parameters;
@@ -57,10 +219,110 @@ private:
     juce::AudioParameterFloat* frequencyParam = nullptr;
     juce::AudioParameterFloat* gainParam = nullptr;
     juce::AudioParameterChoice* waveformParam = nullptr;
+    juce::AudioParameterInt* bendRangeParam = nullptr;
+    juce::AudioParameterBool* mpeParam = nullptr;
+    juce::AudioParameterChoice* playModeParam = nullptr;
+    juce::AudioParameterChoice* glideModeParam = nullptr;
+    juce::AudioParameterFloat* glideTimeParam = nullptr;
+    juce::AudioParameterFloat* cutoffParam = nullptr;
+    juce::AudioParameterFloat* panParam = nullptr;
+
+    struct DelayParameters
+    {
+        juce::AudioParameterBool* enabled = nullptr;
+        juce::AudioParameterFloat* time = nullptr;
+        juce::AudioParameterBool* sync = nullptr;
+        juce::AudioParameterChoice* division = nullptr;
+        juce::AudioParameterFloat* feedback = nullptr;
+        juce::AudioParameterFloat* damping = nullptr;
+        juce::AudioParameterFloat* mix = nullptr;
+        juce::AudioParameterBool* pingPong = nullptr;
+    };
+    DelayParameters delayParams;
+
+    struct ReverbParameters
+    {
+        juce::AudioParameterBool* enabled = nullptr;
+        juce::AudioParameterFloat* decay = nullptr;
+        juce::AudioParameterFloat* damping = nullptr;
+        juce::AudioParameterFloat* mix = nullptr;
+    };
+    ReverbParameters reverbParams;
+
+    juce::AudioParameterBool* convolutionParam = nullptr;
+    juce::AudioParameterFloat* convolutionMixParam = nullptr;
+
+    struct LfoParameters
+    {
+        juce::AudioParameterChoice* shape = nullptr;
+        juce::AudioParameterFloat* rate = nullptr;
+        juce::AudioParameterBool* sync = nullptr;
+        juce::AudioParameterChoice* division = nullptr;
+        juce::AudioParameterChoice* destination = nullptr;
+        juce::AudioParameterFloat* amount = nullptr;
+    };
+    std::array<LfoParameters, numLfos> lfoParams;
+
+    // Presets: the bank is loaded once and never changes, so Program pointers stay valid.
+    // setCurrentProgram publishes a program; processBlock applies it at the next block.
+    std::unique_ptr<PresetBank> presetBank;
+    std::atomic<const PresetBank::Program*> pendingProgram { nullptr };
+    std::atomic<int> currentProgram { 0 };
+
+    // Values changed on the audio thread are stored with setValue() only; the
+    // message-thread timer sends the listener notifications (host, APVTS, editor attachments)
+    // from the message thread, so processBlock never locks or posts messages
+    std::atomic<bool> parameterNotificationPending { false };
+
+    // Telemetry: 'telemetryFrame' is audio-thread scratch, copied into 'telemetry' each block
+    SeqLock<TelemetryFrame> telemetry;
+    TelemetryFrame telemetryFrame;
+    ScopeRing scopeRing;
+
+    MidiControllerMap controllerMap;
+
+    juce::MidiKeyboardState keyboardState;
+    KeyboardMidiQueue keyboardQueue;
 
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    void updateParameters();
+    void applyProgram(const PresetBank::Program& program);
+    void updateNoteIncrements();
+    std::unique_ptr<Tuning> createStartupTuning();
+    void timerCallback() override;
+    void handleMidiMessage(const juce::MidiMessage& msg);
+    void handleController(int channel, int controller, int value);
+    void startNote(int channel, int note, float velocity);
+    void releaseNote(int channel, int note);
+    void addHeldNote(int channel, int note, float velocity);
+    void removeHeldNote(int channel, int note);
+    void forgetHeldNotes(int channel);
+    int getGlideSamples(bool legato) const noexcept;
+    void releaseSustainedNotes(int channel);
+    bool isSustained(int channel) const noexcept;
+    bool isMpeMasterChannel(int channel) const noexcept;
+    SynthVoice& allocateVoice(int channel, int note);
+    float getBendSemitones(int channel) const noexcept;
+    float getPressure(int channel) const noexcept;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void rebuildModulation();
+    void runHousekeeping();
+    void updateTransport();
+    double getSyncedDelaySeconds(double bpm) const noexcept;
+    void applyLfos(SynthVoice::BlockParameters& block, int endSample, int numSamples);
+    void renderVoices(float* left, float* right, int startSample, int numSamples);
+    void applyDelay(float* left, float* right, int numSamples);
+    void applyReverb(float* left, float* right, int numSamples);
+    void applyConvolution(float* left, float* right, int numSamples);
+    void loadStartupImpulseResponse();
+    bool setImpulseResponse(juce::AudioBuffer<float> samples, double rate,
+                            const juce::String& name, juce::String& error);
+    bool restoreImpulseResponse(const juce::ValueTree& state, juce::String& error);
+    static juce::String getLfoParameterID(int lfo, const char* name);
+    void resetControllerMap();
+    void handleNoteOn(juce::MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override;
+    void handleNoteOff(juce::MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override;
+    void publishTelemetry(const juce::AudioBuffer<float>& buffer, juce::int64 startTicks);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleSynthAudioProcessor)
 };
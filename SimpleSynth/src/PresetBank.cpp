@@ -0,0 +1,124 @@
+#include "PresetBank.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr size_t headerSize = 16;
+    constexpr size_t indexEntrySize = PresetBank::nameLength + 8;
+    constexpr size_t valueRecordSize = PresetBank::parameterIdLength + 4;
+    constexpr size_t indexEnd = headerSize + indexEntrySize * PresetBank::maxPresets;
+
+    juce::uint32 readUint32(const char* data)
+    {
+        return juce::ByteOrder::littleEndianInt(data);
+    }
+
+    float readFloat(const char* data)
+    {
+        const juce::uint32 bits = readUint32(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    juce::String readFixedString(const char* data, size_t maxLength)
+    {
+        size_t length = 0;
+        while (length < maxLength && data[length] != 0)
+            ++length;
+
+        return juce::String::fromUTF8(data, (int) length);
+    }
+
+    int findParameterIndex(juce::AudioProcessor& processor, const juce::String& parameterID)
+    {
+        auto& params = processor.getParameters();
+        for (int i = 0; i < params.size(); ++i)
+            if (auto* withId = dynamic_cast<juce::HostedAudioProcessorParameter*>(params[i]))
+                if (withId->getParameterID() == parameterID)
+                    return i;
+
+        return -1;
+    }
+}
+
+std::unique_ptr<PresetBank> PresetBank::loadFromFile(const juce::File& bankFile, juce::AudioProcessor& processor)
+{
+    if (!bankFile.existsAsFile())
+        return nullptr;
+
+    juce::MemoryMappedFile mapped(bankFile, juce::MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const char*>(mapped.getData());
+    const size_t fileSize = mapped.getSize();
+
+    if (data == nullptr || fileSize < indexEnd
+        || std::memcmp(data, "SSBK", 4) != 0
+        || readUint32(data + 4) != bankVersion)
+        return nullptr;
+
+    const int numPresets = juce::jmin((int) readUint32(data + 8), maxPresets);
+    const auto& params = processor.getParameters();
+
+    std::unique_ptr<PresetBank> bank(new PresetBank());
+    bank->programs.reserve((size_t) numPresets);
+
+    for (int p = 0; p < numPresets; ++p)
+    {
+        const char* entry = data + headerSize + indexEntrySize * (size_t) p;
+        const size_t valuesOffset = readUint32(entry + nameLength);
+        const size_t numValues = readUint32(entry + nameLength + 4);
+
+        // Offset first: past the end, the unsigned subtraction below would wrap
+        if (valuesOffset < indexEnd || valuesOffset > fileSize
+            || numValues > (fileSize - valuesOffset) / valueRecordSize)
+            return nullptr;
+
+        Program program;
+        program.name = readFixedString(entry, nameLength);
+        program.values.assign((size_t) params.size(), std::numeric_limits<float>::quiet_NaN());
+
+        for (size_t v = 0; v < numValues; ++v)
+        {
+            const char* record = data + valuesOffset + valueRecordSize * v;
+            const int index = findParameterIndex(processor, readFixedString(record, parameterIdLength));
+
+            // Unknown IDs come from newer or older builds; skip them
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(params[index]))
+                program.values[(size_t) index] = ranged->convertTo0to1(readFloat(record + parameterIdLength));
+        }
+
+        bank->programs.push_back(std::move(program));
+    }
+
+    if (bank->programs.empty())
+        return nullptr;
+
+    return bank;
+}
+
+std::unique_ptr<PresetBank> PresetBank::createDefault(juce::AudioProcessor& processor)
+{
+    Program program;
+    program.name = "Default";
+
+    for (auto* param : processor.getParameters())
+        program.values.push_back(param->getDefaultValue());
+
+    std::unique_ptr<PresetBank> bank(new PresetBank());
+    bank->programs.push_back(std::move(program));
+    return bank;
+}
+
+juce::File PresetBank::getDefaultBankFile()
+{
+    auto path = juce::SystemStats::getEnvironmentVariable("SIMPLESYNTH_PRESET_BANK", {});
+    if (path.isNotEmpty())
+        return juce::File(path);
+
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("SimpleSynth")
+               .getChildFile("SimpleSynth.ssbank");
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <memory>
+#include <vector>
+
+// Read-only preset bank backed by one memory-mapped file with a fixed-size index.
+//
+// File layout (little-endian):
+//   header   "SSBK", uint32 version, uint32 numPresets, uint32 reserved
+//   index    maxPresets entries of: char name[32], uint32 valuesOffset, uint32 numValues
+//   values   per preset, numValues records of: char parameterID[16], float32 value
+//
+// Values are in real parameter units (Hz, 0..1 gain, waveform index). Every
+// preset is resolved against the processor's parameters when the bank is
+// loaded, so selecting a program later is just an index into 'programs'.
+class PresetBank
+{
+public:
+    static constexpr juce::uint32 bankVersion = 1;
+    static constexpr int maxPresets = 128;
+    static constexpr int nameLength = 32;
+    static constexpr int parameterIdLength = 16;
+
+    struct Program
+    {
+        juce::String name;
+        std::vector<float> values;  // Normalised, indexed like getParameters(); NaN = not stored
+    };
+
+    // Returns nullptr if the file is missing or malformed
+    static std::unique_ptr<PresetBank> loadFromFile(const juce::File& bankFile, juce::AudioProcessor& processor);
+
+    // Single "Default" program holding every parameter's default value
+    static std::unique_ptr<PresetBank> createDefault(juce::AudioProcessor& processor);
+
+    // SIMPLESYNTH_PRESET_BANK if set, otherwise SimpleSynth/SimpleSynth.ssbank in the user app-data folder
+    static juce::File getDefaultBankFile();
+
+    int size() const noexcept { return (int) programs.size(); }
+    const Program& getProgram(int index) const noexcept { return programs[(size_t) index]; }
+
+private:
+    PresetBank() = default;
+
+    std::vector<Program> programs;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,135 @@
+#include "StereoDelay.h"
+
+void StereoDelay::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxDelaySamples = juce::jmax(1, (int) std::ceil(maxDelaySeconds * sampleRate));
+    maxChunk = juce::jmax(1, maximumBlockSize);
+
+    // Room for the longest delay plus the chunk being written
+    const int size = juce::nextPowerOfTwo(maxDelaySamples + maxChunk);
+    mask = size - 1;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        lines[(size_t) ch].assign((size_t) size, 0.0f);
+        taps[(size_t) ch].assign((size_t) maxChunk, 0.0f);
+        scratch[(size_t) ch].assign((size_t) maxChunk, 0.0f);
+    }
+
+    reset();
+}
+
+void StereoDelay::reset() noexcept
+{
+    for (auto& line : lines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    dampingState.fill(0.0f);
+    writePosition = 0;
+    currentDelay = 0;
+}
+
+float StereoDelay::getDampingCoefficient(float cutoffHz) const noexcept
+{
+    return (float) (1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoffHz / sampleRate));
+}
+
+void StereoDelay::read(int channel, int delaySamples, float* destination, int numSamples) const noexcept
+{
+    const auto& line = lines[(size_t) channel];
+    const int start = (writePosition - delaySamples) & mask;
+    const int first = juce::jmin(numSamples, mask + 1 - start);
+
+    juce::FloatVectorOperations::copy(destination, line.data() + start, first);
+    juce::FloatVectorOperations::copy(destination + first, line.data(), numSamples - first);
+}
+
+void StereoDelay::write(int channel, const float* source, int numSamples) noexcept
+{
+    auto& line = lines[(size_t) channel];
+    const int first = juce::jmin(numSamples, mask + 1 - writePosition);
+
+    juce::FloatVectorOperations::copy(line.data() + writePosition, source, first);
+    juce::FloatVectorOperations::copy(line.data(), source + first, numSamples - first);
+}
+
+void StereoDelay::process(float* left, float* right, int numSamples, const Settings& settings) noexcept
+{
+    if (mask == 0)
+        return;
+
+    const int numChannels = left == right ? 1 : 2;
+    const bool pingPong = settings.pingPong && numChannels == 2;
+    float* const outputs[] { left, right };
+
+    // A new delay time crossfades from the old tap over this block, instead of jumping
+    const int delay = juce::jlimit(1, maxDelaySamples, settings.delaySamples);
+    const int fadeFrom = currentDelay != delay ? currentDelay : 0;
+    currentDelay = delay;
+
+    for (int done = 0; done < numSamples;)
+    {
+        int chunk = juce::jmin(numSamples - done, delay, maxChunk);
+        if (fadeFrom > 0)
+            chunk = juce::jmin(chunk, fadeFrom);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* tap = taps[(size_t) ch].data();
+            read(ch, delay, tap, chunk);
+
+            if (fadeFrom > 0)
+            {
+                auto* old = scratch[(size_t) ch].data();
+                read(ch, fadeFrom, old, chunk);
+
+                for (int i = 0; i < chunk; ++i)
+                {
+                    const float fade = (float) (done + i + 1) / (float) numSamples;
+                    tap[i] = old[i] + (tap[i] - old[i]) * fade;
+                }
+            }
+
+            // Damping lowpass: echoes darken with each repeat
+            float state = dampingState[(size_t) ch];
+            for (int i = 0; i < chunk; ++i)
+            {
+                state += settings.dampingCoefficient * (tap[i] - state);
+                tap[i] = state;
+            }
+            dampingState[(size_t) ch] = state;
+        }
+
+        // Feed: input plus fed-back taps. Ping-pong sends the input into the
+        // left line only and crosses the feedback, so echoes alternate sides.
+        float* feeds[] { scratch[0].data(), scratch[1].data() };
+        const float* dryLeft = left + done;
+        const float* dryRight = right + done;
+
+        if (pingPong)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(feeds[0], dryLeft, 0.5f, chunk);
+            juce::FloatVectorOperations::addWithMultiply(feeds[0], dryRight, 0.5f, chunk);
+            juce::FloatVectorOperations::addWithMultiply(feeds[0], taps[1].data(), settings.feedback, chunk);
+            juce::FloatVectorOperations::copyWithMultiply(feeds[1], taps[0].data(), settings.feedback, chunk);
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                juce::FloatVectorOperations::copy(feeds[ch], outputs[ch] + done, chunk);
+                juce::FloatVectorOperations::addWithMultiply(feeds[ch], taps[(size_t) ch].data(), settings.feedback, chunk);
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            write(ch, feeds[ch], chunk);
+            juce::FloatVectorOperations::addWithMultiply(outputs[ch] + done, taps[(size_t) ch].data(), settings.mix, chunk);
+        }
+
+        writePosition = (writePosition + chunk) & mask;
+        done += chunk;
+    }
+}
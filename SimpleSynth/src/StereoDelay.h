@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+// Stereo or ping-pong feedback delay, run on the mixed voices.
+//
+// Each line is a power-of-two circular buffer allocated in prepare() for
+// maxDelaySeconds plus one block, so positions wrap with a mask. process()
+// works in chunks no longer than the delay: every sample a chunk reads was
+// written before the chunk started, so the taps are copied out in one or two
+// runs and the feedback, mix and write-back are whole-chunk vector operations.
+// Only the damping lowpass in the feedback path is a per-sample recursion.
+class StereoDelay
+{
+public:
+    static constexpr double maxDelaySeconds = 2.0;
+
+    struct Settings
+    {
+        int delaySamples = 1;
+        float feedback = 0.0f;              // 0..<1
+        float mix = 0.0f;                   // Wet level; the dry signal always passes
+        float dampingCoefficient = 1.0f;    // From getDampingCoefficient(); 1 is undamped
+        bool pingPong = false;
+    };
+
+    // Allocates; call from prepareToPlay
+    void prepare(double sampleRate, int maximumBlockSize);
+    void reset() noexcept;
+
+    int getMaxDelaySamples() const noexcept { return maxDelaySamples; }
+    float getDampingCoefficient(float cutoffHz) const noexcept;
+
+    // In place. Pass the same pointer twice for a mono bus; ping-pong then
+    // behaves as a plain delay.
+    void process(float* left, float* right, int numSamples, const Settings& settings) noexcept;
+
+private:
+    std::array<std::vector<float>, 2> lines, taps, scratch;
+    std::array<float, 2> dampingState {};
+    double sampleRate = 44100.0;
+    int mask = 0;
+    int writePosition = 0;
+    int maxDelaySamples = 1;
+    int maxChunk = 0;
+    int currentDelay = 0;       // 0 until the first block, so it doesn't fade in
+
+    void read(int channel, int delaySamples, float* destination, int numSamples) const noexcept;
+    void write(int channel, const float* source, int numSamples) noexcept;
+};
@@ -0,0 +1,183 @@
+#include "SynthVoice.h"
+
+#include <cmath>
+
+void SynthVoice::prepare(double sampleRate) noexcept
+{
+    smoothing = (float) (1.0 - std::exp(-(double) controlBlockSize / (smoothingSeconds * sampleRate)));
+    inverseSampleRate = (float) (1.0 / sampleRate);
+    maxCutoff = (float) (0.49 * sampleRate);
+    openCoefficient = getFilterCoefficient(maxCutoff);
+    kill();
+}
+
+void SynthVoice::start(int midiChannel, int midiNote, float noteIncrement, float noteVelocity,
+                       juce::uint32 startOrder, float bendSemitones, float pressure) noexcept
+{
+    // A silent voice has phase and envelope at zero (see kill()). A retriggered
+    // or stolen one keeps its phase, ramps to the new pitch over one sub-block
+    // and fades its envelope out before attacking again.
+    snapToTargets = !active;
+    retriggering = active && envelope > 0.0f;
+    active = true;
+    order = startOrder;
+
+    legatoTo(midiChannel, midiNote, noteIncrement, noteVelocity);
+
+    targetBend = currentBend = bendSemitones;
+    targetPressure = currentPressure = pressure;
+    polyPressure = 0.0f;
+}
+
+void SynthVoice::legatoTo(int midiChannel, int midiNote, float noteIncrement, float noteVelocity) noexcept
+{
+    gate = true;
+    sustained = false;
+    channel = midiChannel;
+    note = midiNote;
+    velocity = noteVelocity;
+    baseIncrement = noteIncrement;
+    glideFrom(0.0f, 0);
+}
+
+void SynthVoice::glideFrom(float fromIncrement, int glideSamples) noexcept
+{
+    if (glideSamples <= 0 || fromIncrement <= 0.0f || baseIncrement <= 0.0f)
+    {
+        glideOctaves = 0.0f;
+        glideRemaining = 0;
+        return;
+    }
+
+    glideOctaves = std::log2(fromIncrement / baseIncrement);
+    glideStep = -glideOctaves / (float) glideSamples;
+    glideRemaining = glideSamples;
+}
+
+void SynthVoice::kill() noexcept
+{
+    active = false;
+    gate = false;
+    sustained = false;
+    retriggering = false;
+    note = -1;
+    phase = 0.0f;
+    envelope = 0.0f;
+    filterState = 0.0f;
+}
+
+float SynthVoice::getFilterCoefficient(float cutoff) const noexcept
+{
+    const float g = std::tan(juce::MathConstants<float>::pi * cutoff * inverseSampleRate);
+    return g / (1.0f + g);
+}
+
+template <typename Oscillator>
+void SynthVoice::renderKernel(float* left, float* right, int numSamples, const Steps& steps, Oscillator&& oscillator) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (retriggering)
+        {
+            envelope = juce::jmax(envelope - releaseStep, 0.0f);
+            retriggering = envelope > 0.0f;
+        }
+        else
+        {
+            envelope = gate ? juce::jmin(envelope + attackStep, 1.0f)
+                            : juce::jmax(envelope - releaseStep, 0.0f);
+        }
+
+        increment += steps.increment;
+        leftLevel += steps.left;
+        rightLevel += steps.right;
+        filterCoefficient += steps.coefficient;
+
+        phase += increment;
+        if (phase > 1.0f) phase -= 1.0f;
+
+        // Topology-preserving (trapezoidal) one-pole lowpass
+        const float x = oscillator(phase) * envelope;
+        const float v = (x - filterState) * filterCoefficient;
+        const float y = v + filterState;
+        filterState = y + v;
+
+        left[i] += y * leftLevel;
+        right[i] += y * rightLevel;
+    }
+}
+
+void SynthVoice::render(float* left, float* right, int numSamples, const BlockParameters& block) noexcept
+{
+    if (!active || numSamples <= 0)
+        return;
+
+    // Control rate: smooth expression and advance the glide, then ramp
+    // increment, levels and filter coefficient across the sub-block
+    currentBend += (targetBend - currentBend) * smoothing;
+    currentPressure += (juce::jmax(targetPressure, polyPressure) - currentPressure) * smoothing;
+
+    if (glideRemaining > 0)
+    {
+        const int glided = juce::jmin(numSamples, glideRemaining);
+        glideRemaining -= glided;
+        glideOctaves = glideRemaining > 0 ? glideOctaves + glideStep * (float) glided : 0.0f;
+    }
+
+    // Capped at Nyquist so the kernel's single phase wrap stays valid for any bend
+    const float semitones = currentBend + block.pitchSemitones;
+    const float targetIncrement = juce::jmin(0.5f, baseIncrement * block.pitchScale
+                                                       * std::exp2(semitones / 12.0f + glideOctaves));
+
+    // Balance pan: the centre leaves both sides at full level
+    const float level = block.gain * block.gainFactor * (1.0f + pressureGainDepth * currentPressure);
+    const float pan = juce::jlimit(-1.0f, 1.0f, block.pan + block.panOffset);
+    const float targetLeft = level * juce::jmin(1.0f, 1.0f - pan);
+    const float targetRight = level * juce::jmin(1.0f, 1.0f + pan);
+
+    // An open, unmodulated filter skips the tan
+    float targetCoefficient = openCoefficient;
+    if (block.cutoff < openCutoff || block.cutoffOctaves != 0.0f)
+    {
+        const float base = block.cutoff < openCutoff ? block.cutoff : maxCutoff;
+        targetCoefficient = getFilterCoefficient(juce::jlimit(10.0f, maxCutoff, base * std::exp2(block.cutoffOctaves)));
+    }
+
+    if (snapToTargets)
+    {
+        increment = targetIncrement;
+        leftLevel = targetLeft;
+        rightLevel = targetRight;
+        filterCoefficient = targetCoefficient;
+        snapToTargets = false;
+    }
+
+    const float scale = 1.0f / (float) numSamples;
+    const Steps steps { (targetIncrement - increment) * scale,
+                        (targetLeft - leftLevel) * scale,
+                        (targetRight - rightLevel) * scale,
+                        (targetCoefficient - filterCoefficient) * scale };
+
+    switch (block.waveform)
+    {
+        case Waveform::sine:
+            renderKernel(left, right, numSamples, steps,
+                         [](float p) { return std::sin(p * juce::MathConstants<float>::twoPi); });
+            break;
+        case Waveform::square:
+            renderKernel(left, right, numSamples, steps,
+                         [](float p) { return p < 0.5f ? 1.0f : -1.0f; });
+            break;
+        case Waveform::sawtooth:
+            renderKernel(left, right, numSamples, steps,
+                         [](float p) { return 2.0f * p - 1.0f; });
+            break;
+        case Waveform::triangle:
+            renderKernel(left, right, numSamples, steps,
+                         [](float p) { return p < 0.5f ? 4.0f * p - 1.0f : 3.0f - 4.0f * p; });
+            break;
+    }
+
+    if (!gate && envelope <= 0.0f)
+        kill();
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+
+// One oscillator with a linear attack/release envelope, a one-pole lowpass
+// filter and a balance pan.
+//
+// The processor renders voices in sub-blocks of at most controlBlockSize
+// samples. Expression (pitch bend, pressure), glide and modulation are
+// evaluated once per sub-block and turned into targets for the phase
+// increment, filter coefficient and left/right levels; the sample loop ramps
+// linearly towards those targets, so it only ever adds and multiplies. Glide
+// is linear in octaves, so over the whole glide the increment follows an
+// exponential curve.
+class SynthVoice
+{
+public:
+    static constexpr int controlBlockSize = 32;
+
+    enum class Waveform { sine, square, sawtooth, triangle };
+
+    // Cutoffs at or above this leave the filter fully open (just below Nyquist)
+    static constexpr float openCutoff = 20000.0f;
+
+    // Values for one sub-block, shared by every voice. The modulation fields
+    // are offsets (LFOs) evaluated at the end of the sub-block.
+    struct BlockParameters
+    {
+        Waveform waveform = Waveform::sine;
+        float pitchScale = 1.0f;        // Frequency parameter over 440 Hz
+        float gain = 1.0f;
+        float cutoff = openCutoff;      // Hz
+        float pan = 0.0f;               // -1 (left) .. 1 (right)
+
+        float pitchSemitones = 0.0f;
+        float gainFactor = 1.0f;
+        float cutoffOctaves = 0.0f;
+        float panOffset = 0.0f;
+    };
+
+    void prepare(double sampleRate) noexcept;
+
+    // noteIncrement is the note's phase increment (cycles per sample) from the
+    // tuning table; the expression values are the channel's current ones,
+    // applied without smoothing. A voice that is still sounding keeps its phase
+    // and retriggers the envelope from its current level: it fades to zero at
+    // the release rate, then attacks again, so the new note is heard without a
+    // click.
+    void start(int midiChannel, int midiNote, float noteIncrement, float noteVelocity,
+               juce::uint32 startOrder, float bendSemitones, float pressure) noexcept;
+
+    // Changes note without retriggering the envelope (mono legato)
+    void legatoTo(int midiChannel, int midiNote, float noteIncrement, float noteVelocity) noexcept;
+
+    // Glides from fromIncrement to the current note over glideSamples; call
+    // after start() or legatoTo(). Zero samples (or no source pitch) jumps.
+    void glideFrom(float fromIncrement, int glideSamples) noexcept;
+
+    // Current pitch without bend, including any glide in progress
+    float getPitchIncrement() const noexcept { return baseIncrement * std::exp2(glideOctaves); }
+    void release() noexcept   { gate = false; sustained = false; }
+    void kill() noexcept;
+
+    bool isActive() const noexcept      { return active; }
+    bool isGateOn() const noexcept      { return active && gate; }
+    bool isSustained() const noexcept   { return sustained; }
+    void setSustained() noexcept        { sustained = true; }
+    bool isPlaying(int midiChannel, int midiNote) const noexcept
+    {
+        return isGateOn() && !sustained && channel == midiChannel && note == midiNote;
+    }
+
+    int getChannel() const noexcept             { return channel; }
+    int getNote() const noexcept                { return note; }
+    float getVelocity() const noexcept          { return velocity; }
+    juce::uint32 getStartOrder() const noexcept { return order; }
+    float getEnvelope() const noexcept          { return envelope; }
+
+    // Control-rate targets; the voice smooths towards them in render()
+    void setExpression(float bendSemitones, float pressure) noexcept
+    {
+        targetBend = bendSemitones;
+        targetPressure = pressure;
+    }
+
+    void setPolyPressure(float pressure) noexcept { polyPressure = pressure; }
+    float getPolyPressure() const noexcept        { return polyPressure; }
+
+    // Adds numSamples (<= controlBlockSize) of output to 'left' and 'right'
+    void render(float* left, float* right, int numSamples, const BlockParameters& block) noexcept;
+
+private:
+    static constexpr float attackStep = 0.01f;
+    static constexpr float releaseStep = 0.02f;
+    static constexpr float pressureGainDepth = 0.5f;   // Full pressure = +50% level
+    static constexpr float smoothingSeconds = 0.005f;
+
+    bool active = false;
+    bool gate = false;
+    bool sustained = false;     // Key released while the sustain pedal was down
+    int channel = 0;
+    int note = -1;
+    float velocity = 0.0f;
+    juce::uint32 order = 0;
+
+    float baseIncrement = 0.0f;
+    float phase = 0.0f;
+    float envelope = 0.0f;
+    float increment = 0.0f;     // Current per-sample values, ramped across each sub-block
+    float leftLevel = 0.0f;
+    float rightLevel = 0.0f;
+    float filterCoefficient = 1.0f;
+    float filterState = 0.0f;
+
+    float inverseSampleRate = 1.0f / 44100.0f;
+    float maxCutoff = 0.49f * 44100.0f;
+    float openCoefficient = 1.0f;   // Coefficient at maxCutoff, where an open filter sits
+    bool snapToTargets = false; // First sub-block after a silent start jumps straight to the targets
+    bool retriggering = false;  // Fading out before the attack of a retriggered note
+
+    float glideOctaves = 0.0f;  // Pitch offset from the note, shrinking to 0
+    float glideStep = 0.0f;     // Octaves per sample
+    int glideRemaining = 0;     // Samples
+
+    float targetBend = 0.0f, currentBend = 0.0f;
+    float targetPressure = 0.0f, currentPressure = 0.0f;
+    float polyPressure = 0.0f;
+    float smoothing = 1.0f;     // One-pole coefficient per sub-block
+
+    struct Steps { float increment, left, right, coefficient; };
+
+    float getFilterCoefficient(float cutoff) const noexcept;
+
+    template <typename Oscillator>
+    void renderKernel(float* left, float* right, int numSamples, const Steps& steps, Oscillator&& oscillator) noexcept;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer seqlock for passing a small POD snapshot from the audio thread
+// to the UI. The writer never waits; a reader that races a write just retries,
+// and gives up after a few attempts so a busy audio thread can't stall a paint.
+template <typename Payload>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable<Payload>::value, "SeqLock payload must be trivially copyable");
+
+    // Audio thread only
+    void write(const Payload& value) noexcept
+    {
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);  // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&payload, &value, sizeof(Payload));
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any other thread; returns false if no consistent copy could be taken
+    bool read(Payload& result) const noexcept
+    {
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            std::memcpy(&result, &payload, sizeof(Payload));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    static constexpr int maxReadAttempts = 8;
+
+    std::atomic<juce::uint32> sequence { 0 };
+    Payload payload {};
+};
+
+// What processBlock publishes once per block for the editor
+struct TelemetryFrame
+{
+    static constexpr int maxVoices = 16;
+    static constexpr int waveformPoints = 128;
+
+    juce::uint64 blockCounter = 0;
+    int activeVoices = 0;
+    float voiceLevels[maxVoices] {};      // Envelope level per voice slot
+    float blockMicroseconds = 0.0f;       // Time spent in processBlock
+    float blockLoad = 0.0f;               // blockMicroseconds / block duration
+    int numWaveformPoints = 0;
+    float waveform[waveformPoints] {};    // Last block's output, decimated
+    juce::uint64 audioThreadAllocations = 0;  // Only counted in allocation-check builds
+};
+
+// Wait-free ring of the most recent output samples for the scope and spectrum.
+// The audio thread overwrites the oldest samples and never waits; the UI copies
+// the newest block whenever it wants one. A reader that is lapped mid-copy only
+// gets a torn picture, which is fine for display.
+class ScopeRing
+{
+public:
+    static constexpr int size = 8192;  // Power of two
+    static constexpr int maxRead = size / 2;
+
+    // Audio thread only
+    void push(const float* samples, int numSamples) noexcept
+    {
+        auto position = writePosition.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer[(position + (juce::uint64) i) & mask].store(samples[i], std::memory_order_relaxed);
+
+        writePosition.store(position + (juce::uint64) numSamples, std::memory_order_release);
+    }
+
+    // Copies the newest numSamples (<= maxRead) into dest, oldest first. Returns the
+    // total number of samples ever written, so callers can tell whether anything changed.
+    juce::uint64 readLatest(float* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples <= maxRead);
+        const auto end = writePosition.load(std::memory_order_acquire);
+        const auto start = end - (juce::uint64) numSamples;
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = buffer[(start + (juce::uint64) i) & mask].load(std::memory_order_relaxed);
+
+        return end;
+    }
+
+    juce::uint64 getTotalWritten() const noexcept { return writePosition.load(std::memory_order_acquire); }
+
+private:
+    static constexpr juce::uint64 mask = size - 1;
+
+    std::atomic<float> buffer[size] {};
+    std::atomic<juce::uint64> writePosition { 0 };
+};
@@ -0,0 +1,233 @@
+#include "Tuning.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr int maxScaleSize = 1024;
+    constexpr int unmappedDegree = -1;
+
+    // Non-comment lines; Scala comments start with '!'
+    juce::StringArray getContentLines(const juce::String& text)
+    {
+        juce::StringArray lines;
+        for (auto& line : juce::StringArray::fromLines(text))
+            if (!line.trimStart().startsWithChar('!'))
+                lines.add(line.trim());
+
+        return lines;
+    }
+
+    juce::String firstToken(const juce::String& line)
+    {
+        return juce::StringArray::fromTokens(line, " \t", {})[0];
+    }
+
+    int floorDivide(int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+    }
+
+    // A pitch line is cents if it has a '.', otherwise a ratio ("3/2") or an integer ("2")
+    bool parsePitch(const juce::String& line, double& cents)
+    {
+        auto token = firstToken(line);
+        if (token.isEmpty() || !token.containsOnly("0123456789./-+"))
+            return false;
+
+        if (token.containsChar('.'))
+        {
+            cents = token.getDoubleValue();
+            return true;
+        }
+
+        const double numerator = token.upToFirstOccurrenceOf("/", false, false).getDoubleValue();
+        const double denominator = token.containsChar('/')
+                                     ? token.fromFirstOccurrenceOf("/", false, false).getDoubleValue()
+                                     : 1.0;
+
+        if (numerator <= 0.0 || denominator <= 0.0)
+            return false;
+
+        cents = 1200.0 * std::log2(numerator / denominator);
+        return true;
+    }
+
+    bool parseInt(const juce::String& line, int minValue, int maxValue, int& value)
+    {
+        auto token = firstToken(line);
+        if (!token.containsOnly("0123456789-+") || !token.containsAnyOf("0123456789"))
+            return false;
+
+        value = token.getIntValue();
+        return value >= minValue && value <= maxValue;
+    }
+}
+
+Tuning::Tuning()
+{
+    for (int note = 0; note < numNotes; ++note)
+        frequencies[(size_t) note] = 440.0 * std::exp2((note - 69) / 12.0);
+
+    description = "12-tone equal temperament";
+}
+
+std::unique_ptr<Tuning> Tuning::fromScala(const juce::String& sclText, const juce::String& kbmText,
+                                          juce::String& error)
+{
+    // Scale: description, number of notes, then one pitch per note; the last is the period
+    auto scl = getContentLines(sclText);
+    int scaleSize = 0;
+
+    if (scl.size() < 2 || !parseInt(scl[1], 1, maxScaleSize, scaleSize))
+    {
+        error = "scale file has no valid note count";
+        return nullptr;
+    }
+
+    std::vector<double> pitches;
+    for (int i = 2; i < scl.size() && (int) pitches.size() < scaleSize; ++i)
+    {
+        if (scl[i].isEmpty())
+            continue;
+
+        double cents = 0.0;
+        if (!parsePitch(scl[i], cents))
+        {
+            error = "invalid pitch in scale file: " + scl[i];
+            return nullptr;
+        }
+        pitches.push_back(cents);
+    }
+
+    if ((int) pitches.size() != scaleSize)
+    {
+        error = "scale file lists " + juce::String((int) pitches.size()) + " of " + juce::String(scaleSize) + " notes";
+        return nullptr;
+    }
+
+    // Keyboard mapping: size, first note, last note, middle note, reference note,
+    // reference frequency, formal octave degree, then 'size' degrees (or 'x')
+    int mapSize = 0, firstNote = 0, lastNote = numNotes - 1, middleNote = 60, referenceNote = 60;
+    double referenceFrequency = 261.6255653005986;
+    int octaveDegree = scaleSize;
+    std::vector<int> mapping;
+
+    if (kbmText.trim().isNotEmpty())
+    {
+        auto kbm = getContentLines(kbmText);
+        kbm.removeEmptyStrings();
+
+        if (kbm.size() < 7
+            || !parseInt(kbm[0], 0, numNotes * 8, mapSize)
+            || !parseInt(kbm[1], 0, numNotes - 1, firstNote)
+            || !parseInt(kbm[2], firstNote, numNotes - 1, lastNote)
+            || !parseInt(kbm[3], 0, numNotes - 1, middleNote)
+            || !parseInt(kbm[4], 0, numNotes - 1, referenceNote)
+            || !parseInt(kbm[6], 0, maxScaleSize, octaveDegree))
+        {
+            error = "keyboard mapping header is invalid";
+            return nullptr;
+        }
+
+        referenceFrequency = firstToken(kbm[5]).getDoubleValue();
+        if (referenceFrequency <= 0.0)
+        {
+            error = "keyboard mapping has no valid reference frequency";
+            return nullptr;
+        }
+
+        // Entries the file leaves out are unmapped
+        for (int i = 0; i < mapSize; ++i)
+        {
+            int degree = unmappedDegree;
+            if (7 + i < kbm.size() && !firstToken(kbm[7 + i]).equalsIgnoreCase("x")
+                && !parseInt(kbm[7 + i], 0, maxScaleSize, degree))
+            {
+                error = "invalid degree in keyboard mapping: " + kbm[7 + i];
+                return nullptr;
+            }
+            mapping.push_back(degree);
+        }
+    }
+
+    auto degreeCents = [&pitches, scaleSize](int degree)
+    {
+        const int period = floorDivide(degree, scaleSize);
+        const int step = degree - period * scaleSize;
+        return period * pitches.back() + (step == 0 ? 0.0 : pitches[(size_t) (step - 1)]);
+    };
+
+    auto noteCents = [&](int note, double& cents)
+    {
+        const int offset = note - middleNote;
+        if (mapSize == 0)
+        {
+            cents = degreeCents(offset);
+            return true;
+        }
+
+        const int octave = floorDivide(offset, mapSize);
+        const int degree = mapping[(size_t) (offset - octave * mapSize)];
+        if (degree == unmappedDegree)
+            return false;
+
+        cents = octave * degreeCents(octaveDegree) + degreeCents(degree);
+        return true;
+    };
+
+    double referenceCents = 0.0;
+    if (!noteCents(referenceNote, referenceCents))
+    {
+        error = "keyboard mapping leaves the reference note unmapped";
+        return nullptr;
+    }
+
+    std::unique_ptr<Tuning> tuning(new Tuning());
+
+    for (int note = 0; note < numNotes; ++note)
+    {
+        double cents = 0.0;
+        const bool mapped = note >= firstNote && note <= lastNote && noteCents(note, cents);
+        tuning->frequencies[(size_t) note] = mapped ? referenceFrequency * std::exp2((cents - referenceCents) / 1200.0)
+                                                    : 0.0;
+    }
+
+    tuning->description = scl[0];
+    tuning->scaleText = sclText;
+    tuning->keyboardMapText = kbmText;
+    return tuning;
+}
+
+std::unique_ptr<Tuning> Tuning::loadFromFiles(const juce::File& sclFile, const juce::File& kbmFile,
+                                              juce::String& error)
+{
+    if (!sclFile.existsAsFile())
+    {
+        error = "scale file not found: " + sclFile.getFullPathName();
+        return nullptr;
+    }
+
+    if (kbmFile != juce::File() && !kbmFile.existsAsFile())
+    {
+        error = "keyboard mapping not found: " + kbmFile.getFullPathName();
+        return nullptr;
+    }
+
+    return fromScala(sclFile.loadFileAsString(),
+                     kbmFile != juce::File() ? kbmFile.loadFileAsString() : juce::String(),
+                     error);
+}
+
+juce::File Tuning::getDefaultScaleFile()
+{
+    auto path = juce::SystemStats::getEnvironmentVariable("SIMPLESYNTH_TUNING", {});
+    return path.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(path) : juce::File();
+}
+
+juce::File Tuning::getDefaultKeyboardMapFile()
+{
+    auto path = juce::SystemStats::getEnvironmentVariable("SIMPLESYNTH_KEYBOARD_MAP", {});
+    return path.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(path) : juce::File();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <memory>
+
+// Note frequencies from a Scala scale (.scl) and optional keyboard mapping (.kbm).
+//
+// Both files are resolved into a 128-entry frequency table when they are
+// loaded; the processor turns that into per-note phase increments for the
+// current sample rate, so starting a note is a table lookup. Notes the
+// mapping leaves out have frequency 0 and don't sound.
+//
+// Without a .kbm the scale is mapped linearly with degree 0 on note 60, tuned
+// to 12-TET middle C (261.63 Hz), so a 12-note equal scale is standard pitch.
+class Tuning
+{
+public:
+    static constexpr int numNotes = 128;
+
+    // 12-tone equal temperament, A4 (note 69) = 440 Hz
+    Tuning();
+
+    // Returns nullptr and sets 'error' if either text is malformed; kbmText may be empty
+    static std::unique_ptr<Tuning> fromScala(const juce::String& sclText, const juce::String& kbmText,
+                                             juce::String& error);
+
+    // kbmFile may be File() for the default mapping
+    static std::unique_ptr<Tuning> loadFromFiles(const juce::File& sclFile, const juce::File& kbmFile,
+                                                 juce::String& error);
+
+    // SIMPLESYNTH_TUNING and SIMPLESYNTH_KEYBOARD_MAP; File() when not set
+    static juce::File getDefaultScaleFile();
+    static juce::File getDefaultKeyboardMapFile();
+
+    double getFrequency(int note) const noexcept  { return frequencies[(size_t) note]; }
+    const juce::String& getDescription() const noexcept    { return description; }
+
+    // Source texts, kept so the tuning can be saved with the plugin state; empty for 12-TET
+    const juce::String& getScaleText() const noexcept       { return scaleText; }
+    const juce::String& getKeyboardMapText() const noexcept { return keyboardMapText; }
+
+private:
+    std::array<double, numNotes> frequencies;
+    juce::String description;
+    juce::String scaleText;
+    juce::String keyboardMapText;
+
+    JUCE_LEAK_DETECTOR(Tuning)
+};
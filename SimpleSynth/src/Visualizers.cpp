@@ -0,0 +1,146 @@
+#include "Visualizers.h"
+
+#include <cmath>
+
+//==============================================================================
+ScopeView::ScopeView(const ScopeRing& ringToRead)
+    : ring(ringToRead)
+{
+    setOpaque(true);
+}
+
+void ScopeView::update()
+{
+    if (ring.getTotalWritten() == lastWritten || !isShowing())
+        return;
+
+    lastWritten = ring.readLatest(samples.data(), numSamples);
+    rebuildPath();
+    repaint();
+}
+
+void ScopeView::rebuildPath()
+{
+    // Start on a rising zero crossing in the older half so periodic signals stand still
+    const int displayLength = numSamples / 2;
+    int trigger = 0;
+    for (int i = 1; i < numSamples - displayLength; ++i)
+    {
+        if (samples[(size_t) i - 1] <= 0.0f && samples[(size_t) i] > 0.0f)
+        {
+            trigger = i;
+            break;
+        }
+    }
+
+    auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+    const float dx = bounds.getWidth() / (float) (displayLength - 1);
+
+    path.clear();
+    path.preallocateSpace(displayLength * 3);
+
+    for (int i = 0; i < displayLength; ++i)
+    {
+        const float sample = juce::jlimit(-1.0f, 1.0f, samples[(size_t) (trigger + i)]);
+        const float x = bounds.getX() + dx * (float) i;
+        const float y = bounds.getCentreY() - sample * bounds.getHeight() * 0.5f;
+
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+}
+
+void ScopeView::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::white.withAlpha(0.15f));
+    g.drawHorizontalLine(getHeight() / 2, 0.0f, (float) getWidth());
+
+    g.setColour(juce::Colours::lightgreen);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
+
+void ScopeView::resized()
+{
+    rebuildPath();
+}
+
+//==============================================================================
+SpectrumView::SpectrumView(const ScopeRing& ringToRead)
+    : ring(ringToRead)
+{
+    setOpaque(true);
+    levels.fill(minDecibels);
+}
+
+void SpectrumView::update()
+{
+    if (ring.getTotalWritten() == lastWritten || !isShowing())
+        return;
+
+    lastWritten = ring.readLatest(fftData.data(), fftSize);
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // The window is normalised to unit mean, so a sine of amplitude A peaks at
+    // A * fftSize / 2; scale so a full-scale sine reads about 0 dB
+    const float scale = 2.0f / (float) fftSize;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float db = juce::Decibels::gainToDecibels(fftData[(size_t) bin] * scale, minDecibels);
+        levels[(size_t) bin] = juce::jmax(db, levels[(size_t) bin] - decayPerFrame);
+    }
+
+    rebuildPath();
+    repaint();
+}
+
+void SpectrumView::rebuildPath()
+{
+    auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+    const float minFrequency = 20.0f;
+    const float maxFrequency = (float) sampleRate * 0.5f;
+    const float logRange = std::log(maxFrequency / minFrequency);
+
+    path.clear();
+    path.preallocateSpace(numBins * 3);
+
+    bool started = false;
+    for (int bin = 1; bin < numBins; ++bin)
+    {
+        const float frequency = (float) bin * (float) sampleRate / (float) fftSize;
+        if (frequency < minFrequency)
+            continue;
+
+        const float x = bounds.getX() + bounds.getWidth() * std::log(frequency / minFrequency) / logRange;
+        const float y = juce::jmap(levels[(size_t) bin], minDecibels, 0.0f, bounds.getBottom(), bounds.getY());
+
+        if (!started)
+        {
+            path.startNewSubPath(x, y);
+            started = true;
+        }
+        else
+        {
+            path.lineTo(x, y);
+        }
+    }
+}
+
+void SpectrumView::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(path, juce::PathStrokeType(1.2f));
+}
+
+void SpectrumView::resized()
+{
+    rebuildPath();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+#include "Telemetry.h"
+
+// Oscilloscope over the newest samples in a ScopeRing. update() is called from
+// the editor's timer; it rebuilds the cached path only when new audio arrived
+// and repaints only this component.
+class ScopeView : public juce::Component
+{
+public:
+    static constexpr int numSamples = 1024;
+
+    explicit ScopeView(const ScopeRing& ringToRead);
+
+    void update();
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    const ScopeRing& ring;
+    juce::uint64 lastWritten = 0;
+    std::array<float, (size_t) numSamples> samples {};
+    juce::Path path;
+
+    void rebuildPath();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeView)
+};
+
+// Log-frequency magnitude spectrum. The FFT runs on the message thread inside
+// update(), on buffers allocated once in the constructor.
+class SpectrumView : public juce::Component
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+
+    explicit SpectrumView(const ScopeRing& ringToRead);
+
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+    void update();
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr float minDecibels = -96.0f;
+    static constexpr float decayPerFrame = 1.5f;  // dB, so peaks fall back smoothly
+
+    const ScopeRing& ring;
+    juce::uint64 lastWritten = 0;
+    double sampleRate = 44100.0;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::array<float, (size_t) fftSize * 2> fftData {};
+    std::array<float, (size_t) numBins> levels {};
+    juce::Path path;
+
+    void rebuildPath();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumView)
+};
@@ -0,0 +1,48 @@
+#include "AudioCallbackGuard.h"
+
+#if SIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local int audioCallbackDepth = 0;
+    std::atomic<juce::uint64> allocationCount { 0 };
+
+    void* allocate(std::size_t size)
+    {
+        if (audioCallbackDepth > 0)
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (auto* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void AudioCallbackGuard::enter() noexcept              { ++audioCallbackDepth; }
+void AudioCallbackGuard::exit() noexcept               { --audioCallbackDepth; }
+juce::uint64 AudioCallbackGuard::getAllocationCount() noexcept
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)                                    { return allocate(size); }
+void* operator new[](std::size_t size)                                  { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept                                  { std::free(p); }
+void operator delete[](void* p) noexcept                                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                     { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { std::free(p); }
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Opt-in check that the whole audio callback stays off the heap: the host's
+// own code, the VST3 wrapper applying queued parameter changes and calling
+// the plugin's listeners, and the plugin's processBlock. Configure with
+// -DSIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS=ON and the host replaces the
+// global operator new/delete with versions that count every allocation made
+// while a ScopedAudioCallback is alive on the calling thread. On Linux the
+// executable's definitions also serve the plugin it loads, so allocations
+// inside the plugin binary are counted too.
+//
+// The scope covers each device callback, each batch-rendered block and each
+// multi-timbral worker job. The count is shown by the 'stats' command and
+// printed to stderr at the end of a batch render.
+//
+// With the option off (the default) all of this compiles away.
+namespace AudioCallbackGuard
+{
+   #if SIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS
+    void enter() noexcept;
+    void exit() noexcept;
+    juce::uint64 getAllocationCount() noexcept;
+    constexpr bool isEnabled() noexcept { return true; }
+   #else
+    inline void enter() noexcept {}
+    inline void exit() noexcept {}
+    inline juce::uint64 getAllocationCount() noexcept { return 0; }
+    constexpr bool isEnabled() noexcept { return false; }
+   #endif
+
+    struct ScopedAudioCallback
+    {
+        ScopedAudioCallback() noexcept { enter(); }
+        ~ScopedAudioCallback() noexcept { exit(); }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioCallback)
+    };
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+#include "AudioCallbackGuard.h"
+
+// Measures every audio callback against its deadline (numSamples / sampleRate).
+// The audio thread is the only writer; the statistics are plain relaxed atomics so
+// the console/JSON reporter can read them at any time without blocking the callback.
+class CallbackMonitor : public juce::AudioIODeviceCallback
+{
+public:
+    // Load histogram, as a fraction of the deadline: 0.1% buckets up to 10%, where
+    // a lightly loaded callback sits, then 1% buckets up to 100% and 5% buckets up
+    // to 200%. The last bucket is overflow.
+    struct HistogramTier
+    {
+        double end;      // Exclusive upper load of the tier
+        double width;
+        int numBuckets;
+    };
+
+    static constexpr std::array<HistogramTier, 3> histogramTiers {{ { 0.10, 0.001, 100 },
+                                                                     { 1.00, 0.01,  90 },
+                                                                     { 2.00, 0.05,  20 } }};
+    static constexpr int numBuckets = 100 + 90 + 20 + 1;
+
+    // Bucket a load falls into
+    static int getBucketIndex(double load) noexcept
+    {
+        int first = 0;
+        double start = 0.0;
+
+        for (auto& tier : histogramTiers)
+        {
+            if (load < tier.end)
+                return first + juce::jlimit(0, tier.numBuckets - 1, (int) ((load - start) / tier.width));
+
+            first += tier.numBuckets;
+            start = tier.end;
+        }
+
+        return numBuckets - 1;
+    }
+
+    // Lowest load counted in a bucket; for numBuckets, the end of the last finite bucket
+    static double getBucketStart(int index) noexcept
+    {
+        double start = 0.0;
+
+        for (auto& tier : histogramTiers)
+        {
+            if (index < tier.numBuckets)
+                return start + index * tier.width;
+
+            index -= tier.numBuckets;
+            start = tier.end;
+        }
+
+        return start;
+    }
+
+    struct Snapshot
+    {
+        juce::uint64 callbacks = 0;
+        juce::uint64 overruns = 0;        // Callbacks that took longer than their deadline
+        int deviceXRuns = -1;             // As reported by the driver (-1 = not supported)
+        double sampleRate = 0.0;
+        int bufferSize = 0;
+        double deadlineMs = 0.0;
+        double meanMs = 0.0;
+        double maxMs = 0.0;
+        double meanLoad = 0.0;            // Duration / deadline
+        double p50Load = 0.0;
+        double p99Load = 0.0;
+        double maxLoad = 0.0;
+        std::array<juce::uint32, numBuckets> histogram {};
+
+        juce::String toText() const
+        {
+            return juce::String("[stats] callbacks=") + juce::String((juce::int64) callbacks)
+                 + " overruns=" + juce::String((juce::int64) overruns)
+                 + " xruns=" + (deviceXRuns >= 0 ? juce::String(deviceXRuns) : juce::String("n/a"))
+                 + " deadline=" + juce::String(deadlineMs, 3) + "ms"
+                 + " mean=" + juce::String(meanMs, 3) + "ms"
+                 + " max=" + juce::String(maxMs, 3) + "ms"
+                 + " load p50=" + juce::String(p50Load * 100.0, 1) + "%"
+                 + " p99=" + juce::String(p99Load * 100.0, 1) + "%"
+                 + " max=" + juce::String(maxLoad * 100.0, 1) + "%";
+        }
+
+        juce::var toJson() const
+        {
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty("callbacks", (juce::int64) callbacks);
+            obj->setProperty("overruns", (juce::int64) overruns);
+            obj->setProperty("deviceXRuns", deviceXRuns);
+            obj->setProperty("sampleRate", sampleRate);
+            obj->setProperty("bufferSize", bufferSize);
+            obj->setProperty("deadlineMs", deadlineMs);
+            obj->setProperty("meanMs", meanMs);
+            obj->setProperty("maxMs", maxMs);
+            obj->setProperty("meanLoad", meanLoad);
+            obj->setProperty("p50Load", p50Load);
+            obj->setProperty("p99Load", p99Load);
+            obj->setProperty("maxLoad", maxLoad);
+
+            juce::Array<juce::var> bucketStarts;
+            for (int i = 0; i < numBuckets; ++i)
+                bucketStarts.add(getBucketStart(i));
+            obj->setProperty("bucketStarts", bucketStarts);
+
+            juce::Array<juce::var> buckets;
+            for (auto count : histogram)
+                buckets.add((juce::int64) count);
+            obj->setProperty("histogram", buckets);
+
+            return juce::var(obj);
+        }
+    };
+
+    explicit CallbackMonitor(juce::AudioIODeviceCallback& targetCallback)
+        : target(targetCallback)
+    {
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+    {
+        currentDevice = device;
+        if (device != nullptr)
+        {
+            sampleRate.store(device->getCurrentSampleRate(), std::memory_order_relaxed);
+            bufferSize.store(device->getCurrentBufferSizeSamples(), std::memory_order_relaxed);
+        }
+
+        target.audioDeviceAboutToStart(device);
+    }
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override
+    {
+        AudioCallbackGuard::ScopedAudioCallback audioCallback;
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        target.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                outputChannelData, numOutputChannels,
+                                                numSamples, context);
+
+        const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+        record(elapsed, numSamples);
+    }
+
+    void audioDeviceStopped() override
+    {
+        target.audioDeviceStopped();
+        currentDevice = nullptr;
+    }
+
+    void audioDeviceError(const juce::String& errorMessage) override
+    {
+        target.audioDeviceError(errorMessage);
+    }
+
+    // Safe to call from any thread
+    Snapshot getSnapshot() const
+    {
+        Snapshot s;
+        s.callbacks = callbacks.load(std::memory_order_relaxed);
+        s.overruns = overruns.load(std::memory_order_relaxed);
+        s.sampleRate = sampleRate.load(std::memory_order_relaxed);
+        s.bufferSize = bufferSize.load(std::memory_order_relaxed);
+
+        if (auto* device = currentDevice.load())
+            s.deviceXRuns = device->getXRunCount();
+
+        const auto ticksPerMs = (double) juce::Time::getHighResolutionTicksPerSecond() / 1000.0;
+
+        if (s.sampleRate > 0.0)
+            s.deadlineMs = 1000.0 * s.bufferSize / s.sampleRate;
+
+        if (s.callbacks > 0)
+        {
+            s.meanMs = (double) totalTicks.load(std::memory_order_relaxed) / ticksPerMs / (double) s.callbacks;
+            s.meanLoad = totalLoadMicro.load(std::memory_order_relaxed) / 1.0e6 / (double) s.callbacks;
+        }
+
+        s.maxMs = (double) maxTicks.load(std::memory_order_relaxed) / ticksPerMs;
+        s.maxLoad = maxLoadMicro.load(std::memory_order_relaxed) / 1.0e6;
+
+        juce::uint64 counted = 0;
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            s.histogram[(size_t) i] = histogram[(size_t) i].load(std::memory_order_relaxed);
+            counted += s.histogram[(size_t) i];
+        }
+
+        s.p50Load = percentile(s.histogram, counted, 0.50, s.maxLoad);
+        s.p99Load = percentile(s.histogram, counted, 0.99, s.maxLoad);
+        return s;
+    }
+
+private:
+    juce::AudioIODeviceCallback& target;
+    std::atomic<juce::AudioIODevice*> currentDevice { nullptr };
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<int> bufferSize { 0 };
+
+    // Written only by the audio thread
+    std::atomic<juce::uint64> callbacks { 0 };
+    std::atomic<juce::uint64> overruns { 0 };
+    std::atomic<juce::int64> totalTicks { 0 };
+    std::atomic<juce::int64> maxTicks { 0 };
+    std::atomic<juce::uint64> totalLoadMicro { 0 };  // Load in millionths, to keep it integral
+    std::atomic<juce::uint64> maxLoadMicro { 0 };
+    std::array<std::atomic<juce::uint32>, numBuckets> histogram {};
+
+    void record(juce::int64 elapsedTicks, int numSamples)
+    {
+        const auto rate = sampleRate.load(std::memory_order_relaxed);
+        if (rate <= 0.0 || numSamples <= 0)
+            return;
+
+        const double deadlineTicks = (double) numSamples / rate
+                                   * (double) juce::Time::getHighResolutionTicksPerSecond();
+        const double load = (double) elapsedTicks / deadlineTicks;
+        const auto loadMicro = (juce::uint64) (load * 1.0e6);
+
+        increment(callbacks);
+        if (load > 1.0)
+            increment(overruns);
+
+        totalTicks.store(totalTicks.load(std::memory_order_relaxed) + elapsedTicks, std::memory_order_relaxed);
+        totalLoadMicro.store(totalLoadMicro.load(std::memory_order_relaxed) + loadMicro, std::memory_order_relaxed);
+
+        if (elapsedTicks > maxTicks.load(std::memory_order_relaxed))
+            maxTicks.store(elapsedTicks, std::memory_order_relaxed);
+
+        if (loadMicro > maxLoadMicro.load(std::memory_order_relaxed))
+            maxLoadMicro.store(loadMicro, std::memory_order_relaxed);
+
+        increment(histogram[(size_t) getBucketIndex(load)]);
+    }
+
+    template <typename Counter>
+    static void increment(std::atomic<Counter>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Upper edge of the bucket holding the requested fraction of callbacks: the
+    // histogram can't place it more precisely than that. Never above the observed
+    // maximum, which the bucket edges (and the open-ended overflow bucket) would
+    // otherwise exceed.
+    static double percentile(const std::array<juce::uint32, numBuckets>& buckets,
+                             juce::uint64 total, double fraction, double maxLoad)
+    {
+        if (total == 0)
+            return 0.0;
+
+        const auto target = (juce::uint64) std::ceil(fraction * (double) total);
+        juce::uint64 running = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            const auto count = buckets[(size_t) i];
+            if (running + count >= target && count > 0)
+                return i < numBuckets - 1 ? juce::jmin(maxLoad, getBucketStart(i + 1)) : maxLoad;
+
+            running += count;
+        }
+
+        return maxLoad;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(CallbackMonitor)
+};
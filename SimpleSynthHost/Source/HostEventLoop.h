@@ -0,0 +1,364 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#if JUCE_LINUX
+ #include <poll.h>
+ #include <signal.h>
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+ #include <sys/signalfd.h>
+ #include <sys/socket.h>
+ #include <sys/timerfd.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+#endif
+
+// Main-thread event loop for the interactive host.
+//
+// On Linux everything is a file descriptor in one epoll set: SIGINT/SIGTERM via
+// signalfd, the periodic stats report via timerfd, and a Unix-domain control
+// socket taking one-line commands. The thread sleeps in epoll_wait until one of
+// them fires, so an idle host costs no CPU. Other platforms fall back to a
+// signal flag checked every 100ms, without the control socket.
+//
+// Other threads hand work back to the loop thread with post(), e.g. a plugin
+// build staged in the background that has to be instantiated where the first
+// instance was created. JUCE creates plugin instances through the message
+// thread, and this host never runs a JUCE message loop, so that must be the
+// thread that created the first one.
+class HostEventLoop
+{
+public:
+    using CommandHandler = std::function<juce::String(const juce::String& command)>;
+    using TimerHandler = std::function<void()>;
+    using Callback = std::function<void()>;
+
+    HostEventLoop(const juce::String& controlSocketPath, double timerIntervalSeconds)
+        : socketPath(controlSocketPath), timerInterval(timerIntervalSeconds)
+    {
+    }
+
+    ~HostEventLoop()
+    {
+       #if JUCE_LINUX
+        for (int fd : { epollFd, signalFd, timerFd, wakeFd, postFd, listenFd })
+            if (fd >= 0)
+                ::close(fd);
+
+        if (listenFd >= 0)
+            ::unlink(socketPath.toRawUTF8());
+       #endif
+    }
+
+    // Must run before any other thread is started, so that every thread inherits
+    // the blocked mask and the signals are only ever delivered through signalfd
+    static void blockTerminationSignals()
+    {
+       #if JUCE_LINUX
+        sigset_t signals = terminationSignals();
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+       #else
+        std::signal(SIGINT, [](int) { stopFlag() = true; });
+        std::signal(SIGTERM, [](int) { stopFlag() = true; });
+       #endif
+    }
+
+    // Returns when a termination signal arrives or a handler calls requestStop()
+    void run(const CommandHandler& onCommand, const TimerHandler& onTimer)
+    {
+       #if JUCE_LINUX
+        if (!open())
+            return;
+
+        epoll_event events[8];
+        dispatchPending();  // Anything posted before the loop started
+
+        while (!stopRequested)
+        {
+            int numEvents = epoll_wait(epollFd, events, 8, -1);
+            if (numEvents < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                int fd = events[i].data.fd;
+
+                if (fd == signalFd)
+                {
+                    signalfd_siginfo info;
+                    if (::read(signalFd, &info, sizeof(info)) == (ssize_t) sizeof(info))
+                        std::cout << "\nReceived " << strsignal((int) info.ssi_signo) << std::endl;
+                    stopRequested = true;
+                }
+                else if (fd == timerFd)
+                {
+                    uint64_t expirations = 0;
+                    if (::read(timerFd, &expirations, sizeof(expirations)) > 0 && onTimer)
+                        onTimer();
+                }
+                else if (fd == wakeFd)
+                {
+                    uint64_t value = 0;
+                    (void) ::read(wakeFd, &value, sizeof(value));
+                }
+                else if (fd == postFd)
+                {
+                    uint64_t value = 0;
+                    (void) ::read(postFd, &value, sizeof(value));
+                    dispatchPending();
+                }
+                else if (fd == listenFd)
+                {
+                    handleConnection(onCommand);
+                }
+            }
+        }
+       #else
+        auto nextTimer = juce::Time::getMillisecondCounterHiRes() + timerInterval * 1000.0;
+
+        while (!stopRequested && !stopFlag())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            dispatchPending();
+
+            if (timerInterval > 0.0 && juce::Time::getMillisecondCounterHiRes() >= nextTimer)
+            {
+                if (onTimer)
+                    onTimer();
+                nextTimer += timerInterval * 1000.0;
+            }
+        }
+        juce::ignoreUnused(onCommand);
+       #endif
+    }
+
+    // Safe to call from any thread
+    void requestStop()
+    {
+        stopRequested = true;
+
+       #if JUCE_LINUX
+        if (wakeFd >= 0)
+        {
+            uint64_t one = 1;
+            (void) ::write(wakeFd, &one, sizeof(one));
+        }
+       #endif
+    }
+
+    // Safe to call from any thread: runs 'callback' on the loop thread as soon as it wakes
+    void post(Callback callback)
+    {
+        {
+            const juce::ScopedLock sl(pendingLock);
+            pending.push_back(std::move(callback));
+        }
+
+       #if JUCE_LINUX
+        if (postFd >= 0)
+        {
+            uint64_t one = 1;
+            (void) ::write(postFd, &one, sizeof(one));
+        }
+       #endif
+    }
+
+    // Loop thread: runs the posted callbacks. run() calls this as they arrive;
+    // call it once more after run() has returned to flush the last ones.
+    void dispatchPending()
+    {
+        std::vector<Callback> callbacks;
+        {
+            const juce::ScopedLock sl(pendingLock);
+            callbacks.swap(pending);
+        }
+
+        for (auto& callback : callbacks)
+            callback();
+    }
+
+private:
+    juce::String socketPath;
+    double timerInterval;
+    std::atomic<bool> stopRequested { false };
+
+    juce::CriticalSection pendingLock;
+    std::vector<Callback> pending;
+
+    static std::atomic<bool>& stopFlag()
+    {
+        static std::atomic<bool> flag { false };
+        return flag;
+    }
+
+   #if JUCE_LINUX
+    int epollFd = -1;
+    int signalFd = -1;
+    int timerFd = -1;
+    int wakeFd = -1;
+    int postFd = -1;    // Separate from wakeFd so a post() doesn't abandon a control client
+    int listenFd = -1;
+
+    static constexpr juce::uint32 clientTimeoutMs = 1000;
+
+    static sigset_t terminationSignals()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        return signals;
+    }
+
+    bool open()
+    {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0)
+        {
+            std::cout << "[ERROR] epoll_create1 failed" << std::endl;
+            return false;
+        }
+
+        sigset_t signals = terminationSignals();
+        signalFd = signalfd(-1, &signals, SFD_CLOEXEC);
+        wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        postFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (signalFd < 0 || wakeFd < 0 || postFd < 0)
+        {
+            std::cout << "[ERROR] Failed to create signalfd/eventfd" << std::endl;
+            return false;
+        }
+
+        watch(signalFd);
+        watch(wakeFd);
+        watch(postFd);
+
+        if (timerInterval > 0.0)
+        {
+            timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+            if (timerFd >= 0)
+            {
+                auto nanos = (long long) (timerInterval * 1.0e9);
+                itimerspec spec {};
+                spec.it_interval.tv_sec = (time_t) (nanos / 1000000000LL);
+                spec.it_interval.tv_nsec = (long) (nanos % 1000000000LL);
+                spec.it_value = spec.it_interval;
+                timerfd_settime(timerFd, 0, &spec, nullptr);
+                watch(timerFd);
+            }
+        }
+
+        if (socketPath.isNotEmpty())
+            openControlSocket();
+
+        return true;
+    }
+
+    void watch(int fd)
+    {
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void openControlSocket()
+    {
+        sockaddr_un addr {};
+        addr.sun_family = AF_UNIX;
+
+        if ((size_t) socketPath.getNumBytesAsUTF8() >= sizeof(addr.sun_path))
+        {
+            std::cout << "WARNING: Control socket path too long: " << socketPath << std::endl;
+            return;
+        }
+
+        std::strcpy(addr.sun_path, socketPath.toRawUTF8());
+        ::unlink(addr.sun_path);  // Stale socket from a previous run
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd < 0
+            || ::bind(listenFd, (sockaddr*) &addr, sizeof(addr)) != 0
+            || ::listen(listenFd, 4) != 0)
+        {
+            std::cout << "WARNING: Could not open control socket " << socketPath << std::endl;
+            if (listenFd >= 0)
+                ::close(listenFd);
+            listenFd = -1;
+            return;
+        }
+
+        watch(listenFd);
+        std::cout << "[*] Control socket listening on " << socketPath << std::endl;
+    }
+
+    // One command per connection: read a line, reply, close. A client gets
+    // clientTimeoutMs to send its line. While waiting, a signal or
+    // requestStop() abandons the client at once; the main loop then sees the
+    // still-pending event, so shutdown never waits on a silent client.
+    void handleConnection(const CommandHandler& onCommand)
+    {
+        int client = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            return;
+
+        char buffer[512];
+        juce::String line;
+        bool complete = false;  // A full line, or the client closed its end
+        const auto deadline = juce::Time::getMillisecondCounter() + clientTimeoutMs;
+
+        while (!complete)
+        {
+            const auto now = juce::Time::getMillisecondCounter();
+            if (now >= deadline || stopRequested)
+                break;
+
+            pollfd fds[] { { client, POLLIN, 0 }, { signalFd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+            if (::poll(fds, 3, (int) (deadline - now)) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            if ((fds[1].revents | fds[2].revents) != 0)
+                break;
+
+            if (fds[0].revents == 0)
+                continue;
+
+            const auto bytesRead = ::recv(client, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (bytesRead < 0)
+                break;
+
+            line += juce::String::fromUTF8(buffer, (int) bytesRead);
+            complete = bytesRead == 0 || line.containsChar('\n');
+        }
+
+        auto command = line.upToFirstOccurrenceOf("\n", false, false).trim();
+        if (complete && command.isNotEmpty() && onCommand)
+        {
+            auto reply = onCommand(command) + "\n";
+            ::send(client, reply.toRawUTF8(), reply.getNumBytesAsUTF8(), MSG_NOSIGNAL);
+        }
+
+        ::close(client);
+    }
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(HostEventLoop)
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+
+// Sits in the AudioProcessorPlayer in place of the plugin so a new build can be
+// swapped in without stopping audio. The host owns the instances; this only holds
+// pointers:
+//   1. control thread prepares the new instance and calls beginSwap()
+//   2. the audio thread picks it up at the next block boundary and crossfades
+//      from the old instance over the fade length (both receive the MIDI)
+//   3. once the fade is done the old instance is parked in 'retired', and the
+//      control thread collects and destroys it with takeRetired()
+class HotSwapProcessor : public juce::AudioProcessor
+{
+public:
+    static constexpr int midiBufferReserveBytes = 4096;
+
+    HotSwapProcessor(juce::AudioProcessor& initialProcessor, double fadeLengthMs)
+        : AudioProcessor(BusesProperties()
+              .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          current(&initialProcessor),
+          fadeMs(fadeLengthMs)
+    {
+    }
+
+    // Control thread: 'next' must already be prepared at the current rate and block size
+    void beginSwap(juce::AudioProcessor* next)
+    {
+        jassert(incoming.load() == nullptr && retired.load() == nullptr);
+        incoming.store(next, std::memory_order_release);
+    }
+
+    // Control thread: returns the replaced instance once it is no longer used
+    juce::AudioProcessor* takeRetired()
+    {
+        return retired.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    // Control thread: completes a pending swap without a fade. Used when the device
+    // isn't calling back, so the audio thread would never pick it up.
+    void finishSwapNow()
+    {
+        const juce::ScopedLock sl(getCallbackLock());
+
+        if (auto* next = incoming.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            retired.store(current, std::memory_order_release);
+            current = next;
+        }
+        else if (fadingOut != nullptr)
+        {
+            retired.store(fadingOut, std::memory_order_release);
+            fadingOut = nullptr;
+        }
+    }
+
+    // Audio thread: forwards a parameter change to whichever instance is live
+    void setCurrentParameter(int index, float normalisedValue)
+    {
+        if (auto* param = current->getParameters()[index])
+            param->setValue(normalisedValue);
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override
+    {
+        current->setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+        current->prepareToPlay(sampleRate, samplesPerBlock);
+
+        fadeLength = juce::jmax(1, juce::roundToInt(sampleRate * fadeMs / 1000.0));
+        scratch.setSize(juce::jmax(2, current->getTotalNumInputChannels(), current->getTotalNumOutputChannels()),
+                        juce::jmax(1, samplesPerBlock), false, true, false);
+        scratchMidi.ensureSize(midiBufferReserveBytes);
+        chunkMidi.ensureSize(midiBufferReserveBytes);
+    }
+
+    void releaseResources() override
+    {
+        current->releaseResources();
+    }
+
+    void reset() override
+    {
+        current->reset();
+    }
+
+    void setNonRealtime(bool isNonRealtime) noexcept override
+    {
+        AudioProcessor::setNonRealtime(isNonRealtime);
+        current->setNonRealtime(isNonRealtime);
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
+    {
+        if (fadingOut == nullptr)
+        {
+            if (auto* next = incoming.exchange(nullptr, std::memory_order_acquire))
+            {
+                fadingOut = current;
+                current = next;
+                fadePosition = 0;
+            }
+        }
+
+        if (fadingOut == nullptr)
+        {
+            current->processBlock(buffer, midiMessages);
+            return;
+        }
+
+        // The old instance renders into scratch, so a block longer than the one
+        // prepared for is crossfaded in scratch-sized pieces
+        const int numSamples = buffer.getNumSamples();
+        const int maxChunk = scratch.getNumSamples();
+
+        if (numSamples <= maxChunk)
+        {
+            crossfade(buffer, midiMessages);
+            return;
+        }
+
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const int chunk = juce::jmin(maxChunk, numSamples - start);
+            juce::AudioBuffer<float> part(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, chunk);
+
+            chunkMidi.clear();
+            chunkMidi.addEvents(midiMessages, start, chunk, -start);
+
+            if (fadingOut != nullptr)
+                crossfade(part, chunkMidi);
+            else
+                current->processBlock(part, chunkMidi);
+        }
+    }
+
+    double getTailLengthSeconds() const override { return current->getTailLengthSeconds(); }
+    const juce::String getName() const override { return current->getName(); }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock& destData) override { current->getStateInformation(destData); }
+    void setStateInformation(const void* data, int sizeInBytes) override { current->setStateInformation(data, sizeInBytes); }
+
+private:
+    juce::AudioProcessor* current;                    // Audio thread owns this pointer while playing
+    juce::AudioProcessor* fadingOut = nullptr;
+    std::atomic<juce::AudioProcessor*> incoming { nullptr };
+    std::atomic<juce::AudioProcessor*> retired { nullptr };
+
+    double fadeMs;
+    int fadeLength = 1;
+    int fadePosition = 0;
+    juce::AudioBuffer<float> scratch;
+    juce::MidiBuffer scratchMidi, chunkMidi;
+
+    // Audio thread: renders one block no longer than scratch through both instances
+    void crossfade(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = juce::jmin(buffer.getNumChannels(), scratch.getNumChannels());
+
+        // Old instance renders the same block into scratch
+        juce::AudioBuffer<float> oldBlock(scratch.getArrayOfWritePointers(), scratch.getNumChannels(), numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+            oldBlock.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+        scratchMidi.clear();
+        scratchMidi.addEvents(midiMessages, 0, numSamples, 0);
+        fadingOut->processBlock(oldBlock, scratchMidi);
+
+        current->processBlock(buffer, midiMessages);
+
+        // Linear crossfade: new instance ramps in, old one ramps out
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* out = buffer.getWritePointer(ch);
+            const auto* old = oldBlock.getReadPointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float gain = juce::jmin(1.0f, (float) (fadePosition + i) / (float) fadeLength);
+                out[i] = out[i] * gain + old[i] * (1.0f - gain);
+            }
+        }
+
+        fadePosition += numSamples;
+        if (fadePosition >= fadeLength)
+        {
+            retired.store(fadingOut, std::memory_order_release);
+            fadingOut = nullptr;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HotSwapProcessor)
+};
@@ -5,14 +5,41 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
-#include <winsock2.h>
 #include <queue>
 #include <mutex>
 #include <map>
-#include <io.h>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <cstring>
 #include <fcntl.h>
 
-#pragma comment(lib, "ws2_32.lib")
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <io.h>
+    #pragma comment(lib, "ws2_32.lib")
+    using socklen_t = int;
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    using SOCKET = int;
+    constexpr SOCKET INVALID_SOCKET = -1;
+    constexpr int SOCKET_ERROR = -1;
+    inline int closesocket(SOCKET s) { return ::close(s); }
+#endif
+
+#include "RealtimeProfile.h"
+#include "AudioCallbackGuard.h"
+#include "CallbackMonitor.h"
+#include "SimulatedAudioDevice.h"
+#include "HostEventLoop.h"
+#include "OSCParameterControl.h"
+#include "ParameterLookup.h"
+#include "ParameterAutomation.h"
+#include "MultiTimbralProcessor.h"
+#include "HotSwapProcessor.h"
 
 using namespace juce;
 
@@ -25,7 +52,21 @@ struct CommandLineOptions
     int sampleRate = 44100;
     int blockSize = 512;
     int numChannels = 2;
-    std::map<String, float> parameters;  // Parameter name -> value
+    std::map<String, String> parameters;  // Parameter ID or name -> value text
+    std::map<int, std::map<String, String>> timbreParameters;  // MIDI channel -> ID or name -> value text
+    String automationPath;               // Breakpoint file for sample-accurate automation (batch mode)
+    int numTimbres = 1;                  // Plugin instances, one per MIDI channel
+    int renderThreads = -1;              // Worker threads for multi-timbral rendering (-1 = auto)
+    double reloadFadeMs = 20.0;          // Crossfade when hot-reloading the plugin binary
+    RealtimeProfile realtime;            // Interactive mode only
+    bool simulatedDevice = false;        // Timer-driven virtual device instead of sound hardware
+    bool maxSpeed = false;               // Simulated device renders blocks back-to-back
+    int audioTapPort = 0;                // Stream rendered output over UDP (0 = off)
+    double statsInterval = 10.0;         // Seconds between callback stats reports (0 = off)
+    String statsJsonPath;                // "-" = JSON lines on stdout instead of text
+    String controlSocketPath;            // Unix-domain control socket (empty = off)
+    int oscPort = 0;                     // OSC parameter control over UDP (0 = off)
+    String oscBindAddress = "127.0.0.1"; // Interface the OSC endpoint listens on
 
     static CommandLineOptions parse(int argc, char* argv[])
     {
@@ -40,34 +81,145 @@ struct CommandLineOptions
         if (args.containsOption("--samplerate"))
             opts.sampleRate = args.getValueForOption("--samplerate").getIntValue();
 
-        // Parse --param arguments
+        if (args.containsOption("--blocksize"))
+            opts.blockSize = args.getValueForOption("--blocksize").getIntValue();
+
+        // Simulated audio device (interactive mode without a soundcard)
+        opts.maxSpeed = args.containsOption("--max-speed");
+        opts.simulatedDevice = opts.maxSpeed || args.containsOption("--simulated");
+
+        if (args.containsOption("--audio-tap"))
+            opts.audioTapPort = args.getValueForOption("--audio-tap").getIntValue();
+
+        // Realtime profile (interactive mode, Linux)
+        opts.realtime.enabled = args.containsOption("--realtime");
+
+        if (args.containsOption("--rt-priority"))
+            opts.realtime.priority = args.getValueForOption("--rt-priority").getIntValue();
+
+        if (args.containsOption("--audio-cpu"))
+            opts.realtime.audioCpu = args.getValueForOption("--audio-cpu").getIntValue();
+
+        if (args.containsOption("--udp-cpu"))
+            opts.realtime.udpCpu = args.getValueForOption("--udp-cpu").getIntValue();
+
+        // Callback deadline statistics (interactive mode)
+        if (args.containsOption("--stats-interval"))
+            opts.statsInterval = args.getValueForOption("--stats-interval").getDoubleValue();
+
+        if (args.containsOption("--stats-json"))
+            opts.statsJsonPath = args.getValueForOption("--stats-json");
+
+        if (args.containsOption("--control-socket"))
+            opts.controlSocketPath = args.getValueForOption("--control-socket");
+
+        if (args.containsOption("--osc-port"))
+            opts.oscPort = args.getValueForOption("--osc-port").getIntValue();
+
+        if (args.containsOption("--osc-bind"))
+            opts.oscBindAddress = args.getValueForOption("--osc-bind");
+
+        // Multi-timbral mode
+        if (args.containsOption("--timbres"))
+            opts.numTimbres = jlimit(1, 16, args.getValueForOption("--timbres").getIntValue());
+
+        if (args.containsOption("--render-threads"))
+            opts.renderThreads = args.getValueForOption("--render-threads").getIntValue();
+
+        if (args.containsOption("--automation"))
+            opts.automationPath = args.getValueForOption("--automation");
+
+        if (args.containsOption("--reload-fade-ms"))
+            opts.reloadFadeMs = jmax(0.1, args.getValueForOption("--reload-fade-ms").getDoubleValue());
+
+        // Parse --param arguments: "--param Name=value" or "--param <channel>:Name=value".
+        // Values are kept as text and resolved against the plugin once it is loaded.
         for (int i = 1; i < args.size(); ++i)
         {
             String arg = args[i].text;
-            if (arg.startsWith("--param"))
+            String paramSpec;
+
+            if (arg == "--param" && i + 1 < args.size())
+                paramSpec = args[++i].text;
+            else if (arg.startsWith("--param="))
+                paramSpec = arg.fromFirstOccurrenceOf("=", false, false);
+            else
+                continue;
+
+            int equalsPos = paramSpec.indexOfChar('=');
+            if (equalsPos > 0)
             {
-                String paramSpec = args.getValueForOption(arg);
-                int equalsPos = paramSpec.indexOfChar('=');
-                if (equalsPos > 0)
-                {
-                    String name = paramSpec.substring(0, equalsPos).trim();
-                    float value = paramSpec.substring(equalsPos + 1).getFloatValue();
+                String name = paramSpec.substring(0, equalsPos).trim();
+                String value = paramSpec.substring(equalsPos + 1).trim();
+                int colonPos = name.indexOfChar(':');
+
+                if (colonPos > 0 && name.substring(0, colonPos).containsOnly("0123456789"))
+                    opts.timbreParameters[name.substring(0, colonPos).getIntValue()][name.substring(colonPos + 1)] = value;
+                else
                     opts.parameters[name] = value;
-                }
             }
         }
 
-        // Auto-detect stdin pipe on Windows
+        // Auto-detect stdin pipe on Windows (a simulated device always means
+        // interactive mode, since CI runners rarely have a terminal on stdin)
         #ifdef _WIN32
-            opts.batchMode = opts.stdinMode || !_isatty(_fileno(stdin));
+            bool stdinIsPipe = !_isatty(_fileno(stdin));
         #else
-            opts.batchMode = opts.stdinMode || !isatty(fileno(stdin));
+            bool stdinIsPipe = !isatty(fileno(stdin));
         #endif
+        opts.batchMode = opts.stdinMode || (stdinIsPipe && !opts.simulatedDevice);
 
         return opts;
     }
 };
 
+// Sets parameters by ID or display name; returns how many were set. Unknown
+// names and unparseable values are added to 'errors' rather than ignored.
+int applyParameterValues(const ParameterLookup& lookup, const std::map<String, String>& values, StringArray& errors)
+{
+    int applied = 0;
+
+    for (const auto& [name, valueText] : values)
+    {
+        auto* param = lookup.find(name);
+        if (param == nullptr)
+        {
+            errors.add("unknown parameter '" + name + "' (available: " + lookup.getNames().joinIntoString(", ") + ")");
+            continue;
+        }
+
+        float normalised = 0.0f;
+        if (!ParameterLookup::toNormalised(*param, valueText, normalised))
+        {
+            errors.add("invalid value '" + valueText + "' for parameter '" + name + "'");
+            continue;
+        }
+
+        param->setValueNotifyingHost(normalised);
+        applied++;
+    }
+    return applied;
+}
+
+// Applies the --param values: global ones to every instance, "<channel>:" ones
+// only to the instance playing that channel in multi-timbral mode. 'lookups'
+// comes from createParameterLookups() on the processor being set up.
+int applyConfiguredParameters(const ParameterLookups& lookups, const CommandLineOptions& opts, StringArray& errors)
+{
+    int applied = 0;
+    for (size_t i = 0; i < lookups.size(); ++i)
+    {
+        applied += applyParameterValues(*lookups[i], opts.parameters, errors);
+
+        auto channelValues = opts.timbreParameters.find((int) i + 1);
+        if (channelValues != opts.timbreParameters.end())
+            applied += applyParameterValues(*lookups[i], channelValues->second, errors);
+    }
+
+    errors.removeDuplicates(false);
+    return applied;
+}
+
 // MIDI reader from stdin - raw MIDI bytes
 class StdinMidiReader
 {
@@ -85,7 +237,8 @@ public:
         int dataBytes = 0;
 
         // Determine how many data bytes to read
-        if ((status & 0xF0) == 0x80 || (status & 0xF0) == 0x90 || (status & 0xF0) == 0xB0)
+        if ((status & 0xF0) == 0x80 || (status & 0xF0) == 0x90 || (status & 0xF0) == 0xA0
+            || (status & 0xF0) == 0xB0 || (status & 0xF0) == 0xE0)
             dataBytes = 2;
         else if ((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0)
             dataBytes = 1;
@@ -100,8 +253,16 @@ public:
             msg = MidiMessage::noteOn((status & 0x0F) + 1, buffer[1], buffer[2] / 127.0f);
         else if ((status & 0xF0) == 0x80)
             msg = MidiMessage::noteOff((status & 0x0F) + 1, buffer[1], buffer[2] / 127.0f);
+        else if ((status & 0xF0) == 0xA0)
+            msg = MidiMessage::aftertouchChange((status & 0x0F) + 1, buffer[1], buffer[2]);
         else if ((status & 0xF0) == 0xB0)
             msg = MidiMessage::controllerEvent((status & 0x0F) + 1, buffer[1], buffer[2]);
+        else if ((status & 0xF0) == 0xE0)
+            msg = MidiMessage::pitchWheel((status & 0x0F) + 1, buffer[1] | (buffer[2] << 7));
+        else if ((status & 0xF0) == 0xC0)
+            msg = MidiMessage::programChange((status & 0x0F) + 1, buffer[1]);
+        else
+            msg = MidiMessage::channelPressureChange((status & 0x0F) + 1, buffer[1]);
 
         return true;
     }
@@ -149,7 +310,7 @@ private:
 class OfflineRenderer
 {
 public:
-    OfflineRenderer(AudioPluginInstance* pluginInstance, const CommandLineOptions& opts)
+    OfflineRenderer(AudioProcessor* pluginInstance, const CommandLineOptions& opts)
         : plugin(pluginInstance), options(opts)
     {
     }
@@ -210,22 +371,43 @@ public:
                                   plugin->getTotalNumInputChannels(),
                                   plugin->getTotalNumOutputChannels());
 
-            // Apply parameters
-            int paramsApplied = 0;
-            for (const auto& [name, value] : options.parameters)
+            // Apply parameters, resolving names against the plugin once for --param and --automation
+            auto parameterLookups = createParameterLookups(*plugin);
+            StringArray paramErrors;
+            int paramsApplied = applyConfiguredParameters(parameterLookups, options, paramErrors);
+            if (debugLog) fprintf(debugLog, "[DEBUG] Applied %d parameters\n", paramsApplied);
+
+            if (!paramErrors.isEmpty())
             {
-                for (int i = 0; i < plugin->getNumParameters(); ++i)
+                for (auto& error : paramErrors)
+                    std::cerr << "ERROR: --param: " << error << std::endl;
+
+                plugin->releaseResources();
+                if (debugLog) fclose(debugLog);
+                return 1;
+            }
+
+            // Load automation lanes, resolved against the plugin's parameters once
+            std::unique_ptr<ParameterAutomation> automation;
+            if (options.automationPath.isNotEmpty())
+            {
+                automation = std::make_unique<ParameterAutomation>();
+                StringArray automationErrors;
+                File automationFile = File::getCurrentWorkingDirectory().getChildFile(options.automationPath);
+
+                if (!automation->loadFromFile(automationFile, parameterLookups, options.sampleRate, automationErrors))
                 {
-                    if (plugin->getParameterName(i) == name)
-                    {
-                        plugin->setParameter(i, value);
-                        if (debugLog) fprintf(debugLog, "[DEBUG] Set parameter: %s = %f\n", name.toRawUTF8(), value);
-                        paramsApplied++;
-                        break;
-                    }
+                    for (auto& error : automationErrors)
+                        std::cerr << "ERROR: --automation: " << error << std::endl;
+
+                    plugin->releaseResources();
+                    if (debugLog) fclose(debugLog);
+                    return 1;
                 }
+
+                automation->prepare();
+                if (debugLog) fprintf(debugLog, "[DEBUG] Loaded %d automation lanes\n", automation->getNumLanes());
             }
-            if (debugLog) fprintf(debugLog, "[DEBUG] Applied %d parameters\n", paramsApplied);
 
             // Set up I/O
             StdinMidiReader midiReader;
@@ -335,8 +517,15 @@ public:
                     }
                 }
 
-                // Process audio block with plugin
-                plugin->processBlock(outputBuffer, midiBuffer);
+                // Process audio block with plugin (split at automation breakpoints)
+                {
+                    AudioCallbackGuard::ScopedAudioCallback audioCallback;
+
+                    if (automation)
+                        automation->process(*plugin, outputBuffer, midiBuffer);
+                    else
+                        plugin->processBlock(outputBuffer, midiBuffer);
+                }
 
                 // Debug: check if we got audio
                 if (blockNum == 0 && eventsThisBlock > 0)
@@ -372,6 +561,10 @@ public:
 
             if (debugLog) fprintf(debugLog, "[DEBUG] Render loop completed. Total MIDI events: %d, blocks: %d\n", totalMidiEventsRead, blockNum);
 
+            if (AudioCallbackGuard::isEnabled())
+                std::cerr << "[SimpleSynthHost] audio-thread allocations: "
+                          << (int64) AudioCallbackGuard::getAllocationCount() << std::endl;
+
             // Cleanup
             plugin->releaseResources();
             plugin->setNonRealtime(false);
@@ -389,7 +582,7 @@ public:
     }
 
 private:
-    AudioPluginInstance* plugin;
+    AudioProcessor* plugin;
     CommandLineOptions options;
 };
 
@@ -399,17 +592,23 @@ class UDPMIDIReceiver
 public:
     UDPMIDIReceiver(MidiMessageCollector& collector) : midiCollector(collector)
     {
-        WSAStartup(MAKEWORD(2, 2), &wsaData);
+        #ifdef _WIN32
+            WSAStartup(MAKEWORD(2, 2), &wsaData);
+        #endif
     }
 
     ~UDPMIDIReceiver()
     {
         stop();
-        WSACleanup();
+        #ifdef _WIN32
+            WSACleanup();
+        #endif
     }
 
-    bool start(int port = 9999)
+    bool start(int port = 9999, int cpu = -1)
     {
+        pinnedCpu = cpu;
+
         socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
         if (socket == INVALID_SOCKET)
         {
@@ -440,6 +639,9 @@ public:
         running = false;
         if (socket != INVALID_SOCKET)
         {
+            #ifndef _WIN32
+                ::shutdown(socket, SHUT_RDWR);  // Wake a blocking recvfrom()
+            #endif
             closesocket(socket);
             socket = INVALID_SOCKET;
         }
@@ -449,23 +651,31 @@ public:
 
 private:
     MidiMessageCollector& midiCollector;
-    WSADATA wsaData;
+    #ifdef _WIN32
+        WSADATA wsaData;
+    #endif
     SOCKET socket = INVALID_SOCKET;
-    bool running = false;
+    std::atomic<bool> running { false };
+    int pinnedCpu = -1;
     std::thread receiverThread;
 
     void receiveLoop()
     {
-        unsigned char buffer[3];
+        if (pinnedCpu >= 0 && !RealtimeProfile::pinCurrentThreadToCpu(pinnedCpu))
+            std::cout << "WARNING: Could not pin UDP thread to CPU " << pinnedCpu << std::endl;
+
+        unsigned char buffer[3] = {};
         sockaddr_in fromAddr;
-        int fromAddrLen = sizeof(fromAddr);
+        socklen_t fromAddrLen = sizeof(fromAddr);
 
         while (running)
         {
             int bytesReceived = recvfrom(socket, (char*)buffer, sizeof(buffer), 0,
                                         (sockaddr*)&fromAddr, &fromAddrLen);
 
-            if (bytesReceived == 3)
+            // Program change and channel pressure are 2-byte messages; everything else we handle is 3 bytes
+            if (bytesReceived == 3
+                || (bytesReceived == 2 && ((buffer[0] & 0xF0) == 0xC0 || (buffer[0] & 0xF0) == 0xD0)))
             {
                 // Parse MIDI message
                 uint8 status = buffer[0];
@@ -487,6 +697,22 @@ private:
                 {
                     msg = MidiMessage::controllerEvent((status & 0x0F) + 1, data1, data2);
                 }
+                else if ((status & 0xF0) == 0xC0)  // Program Change
+                {
+                    msg = MidiMessage::programChange((status & 0x0F) + 1, data1);
+                }
+                else if ((status & 0xF0) == 0xA0)  // Polyphonic Aftertouch
+                {
+                    msg = MidiMessage::aftertouchChange((status & 0x0F) + 1, data1, data2);
+                }
+                else if ((status & 0xF0) == 0xD0)  // Channel Pressure
+                {
+                    msg = MidiMessage::channelPressureChange((status & 0x0F) + 1, data1);
+                }
+                else if ((status & 0xF0) == 0xE0)  // Pitch Bend
+                {
+                    msg = MidiMessage::pitchWheel((status & 0x0F) + 1, data1 | (data2 << 7));
+                }
                 else
                 {
                     continue;  // Skip unsupported message types
@@ -504,12 +730,178 @@ private:
     }
 };
 
+// UDP audio tap - streams the rendered output to a local port so an external
+// tool (latency_harness.py) can see exactly when audio was produced. The audio
+// thread only copies into a preallocated FIFO; a sender thread does the socket work.
+//
+// Packet layout (native endianness):
+//   char[4]  magic "SSTP"
+//   uint64   steady-clock time at callback start, in nanoseconds
+//   double   sample rate
+//   uint32   number of samples in this block
+//   uint32   device output latency in samples
+//   float32  samples of the first output channel
+class UDPAudioTap : public AudioIODeviceCallback
+{
+public:
+    static constexpr int maxBlockSamples = 8192;
+    static constexpr int headerSize = 4 + 8 + 8 + 4 + 4;
+
+    UDPAudioTap(AudioIODeviceCallback& targetCallback) : target(targetCallback)
+    {
+        #ifdef _WIN32
+            WSAStartup(MAKEWORD(2, 2), &wsaData);
+        #endif
+
+        for (auto& packet : packets)
+            packet.resize((size_t) (headerSize + maxBlockSamples * (int) sizeof(float)));
+    }
+
+    ~UDPAudioTap()
+    {
+        stop();
+        #ifdef _WIN32
+            WSACleanup();
+        #endif
+    }
+
+    bool start(int port)
+    {
+        socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (socket == INVALID_SOCKET)
+        {
+            std::cout << "[ERROR] Failed to create UDP audio tap socket" << std::endl;
+            return false;
+        }
+
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(port);
+        destination.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+        running = true;
+        senderThread = std::thread(&UDPAudioTap::sendLoop, this);
+        std::cout << "[*] UDP audio tap sending to port " << port << std::endl;
+        return true;
+    }
+
+    void stop()
+    {
+        running = false;
+        if (senderThread.joinable())
+            senderThread.join();
+        if (socket != INVALID_SOCKET)
+        {
+            closesocket(socket);
+            socket = INVALID_SOCKET;
+        }
+    }
+
+    int getDroppedBlocks() const { return droppedBlocks.load(); }
+
+    void audioDeviceAboutToStart(AudioIODevice* device) override
+    {
+        sampleRate = device != nullptr ? device->getCurrentSampleRate() : 0.0;
+        outputLatency = device != nullptr ? (uint32) device->getOutputLatencyInSamples() : 0;
+        target.audioDeviceAboutToStart(device);
+    }
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const AudioIODeviceCallbackContext& context) override
+    {
+        const auto callbackTimeNs = (uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        target.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                outputChannelData, numOutputChannels,
+                                                numSamples, context);
+
+        if (numOutputChannels < 1 || outputChannelData[0] == nullptr)
+            return;
+
+        auto scope = fifo.write(1);
+        if (scope.blockSize1 == 0)
+        {
+            ++droppedBlocks;  // Sender fell behind; never block the audio thread
+            return;
+        }
+
+        auto& packet = packets[(size_t) scope.startIndex1];
+        auto samples = (uint32) jmin(numSamples, maxBlockSamples);
+        char* dest = packet.data();
+
+        std::memcpy(dest, "SSTP", 4);                          dest += 4;
+        std::memcpy(dest, &callbackTimeNs, sizeof(uint64));    dest += sizeof(uint64);
+        std::memcpy(dest, &sampleRate, sizeof(double));        dest += sizeof(double);
+        std::memcpy(dest, &samples, sizeof(uint32));           dest += sizeof(uint32);
+        std::memcpy(dest, &outputLatency, sizeof(uint32));     dest += sizeof(uint32);
+        std::memcpy(dest, outputChannelData[0], samples * sizeof(float));
+
+        packetSizes[(size_t) scope.startIndex1] = headerSize + (int) (samples * sizeof(float));
+    }
+
+    void audioDeviceStopped() override
+    {
+        target.audioDeviceStopped();
+    }
+
+    void audioDeviceError(const String& errorMessage) override
+    {
+        target.audioDeviceError(errorMessage);
+    }
+
+private:
+    static constexpr int numPackets = 64;
+
+    AudioIODeviceCallback& target;
+    #ifdef _WIN32
+        WSADATA wsaData;
+    #endif
+    SOCKET socket = INVALID_SOCKET;
+    sockaddr_in destination {};
+    std::atomic<bool> running { false };
+    std::thread senderThread;
+
+    double sampleRate = 0.0;
+    uint32 outputLatency = 0;
+    AbstractFifo fifo { numPackets };
+    std::array<std::vector<char>, numPackets> packets;
+    std::array<int, numPackets> packetSizes {};
+    std::atomic<int> droppedBlocks { 0 };
+
+    void sendLoop()
+    {
+        while (running)
+        {
+            bool sentAny = false;
+
+            while (fifo.getNumReady() > 0)
+            {
+                auto scope = fifo.read(1);
+                auto index = (size_t) scope.startIndex1;
+                sendto(socket, packets[index].data(), packetSizes[index], 0,
+                       (sockaddr*)&destination, sizeof(destination));
+                sentAny = true;
+            }
+
+            if (!sentAny)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+File getDefaultPluginFile();
+std::unique_ptr<AudioPluginInstance> loadPluginFromFile(const File& vst3File, int sampleRate, int blockSize);
+
 // Interactive host with UDP MIDI support
 class SimpleSynthHost
 {
 public:
-    SimpleSynthHost(std::unique_ptr<AudioPluginInstance> pluginInstance)
-        : plugin(std::move(pluginInstance))
+    SimpleSynthHost(std::unique_ptr<AudioProcessor> pluginInstance, const CommandLineOptions& opts)
+        : plugin(std::move(pluginInstance)), options(opts)
     {
     }
 
@@ -518,13 +910,31 @@ public:
         try
         {
             std::cout << "===== SimpleSynth Host =====" << std::endl;
+
+            if (options.realtime.enabled)
+            {
+                if (RealtimeProfile::lockMemory())
+                    std::cout << "Realtime profile: process memory locked." << std::endl;
+                else
+                    std::cout << "WARNING: mlockall failed (check RLIMIT_MEMLOCK / CAP_IPC_LOCK)" << std::endl;
+            }
+
             std::cout << "Initializing audio device..." << std::endl;
 
+            // Registering the simulated type before initialise() stops the manager
+            // from creating (and probing) the hardware device types at all
+            if (options.simulatedDevice)
+            {
+                deviceManager.addAudioDeviceType(std::make_unique<SimulatedAudioIODeviceType>(options.maxSpeed));
+                std::cout << "Using simulated audio device"
+                          << (options.maxSpeed ? " (max speed)" : "") << std::endl;
+            }
+
             // Setup audio device with explicit sample rate and buffer size
             AudioDeviceManager::AudioDeviceSetup setup;
             deviceManager.getAudioDeviceSetup(setup);
-            setup.sampleRate = 44100.0;
-            setup.bufferSize = 512;
+            setup.sampleRate = options.sampleRate;
+            setup.bufferSize = options.blockSize;
 
             String error = deviceManager.initialise(0, 2, nullptr, true, {}, &setup);
 
@@ -545,10 +955,6 @@ public:
                 std::cout << "Buffer size: " << device->getCurrentBufferSizeSamples() << " samples" << std::endl;
             }
 
-            // Connect audio player to audio device
-            deviceManager.addAudioCallback(&player);
-            std::cout << "Audio player connected to device." << std::endl;
-
             // List and enable all MIDI inputs
             std::cout << "\nAvailable MIDI inputs:" << std::endl;
             auto midiInputs = MidiInput::getAvailableDevices();
@@ -579,10 +985,63 @@ public:
             // Enable all buses
             plugin->enableAllBuses();
 
+            parameterLookups = createParameterLookups(*plugin);
+            StringArray paramErrors;
+            applyConfiguredParameters(parameterLookups, options, paramErrors);
+            if (!paramErrors.isEmpty())
+            {
+                for (auto& error : paramErrors)
+                    std::cout << "[ERROR] --param: " << error << std::endl;
+                return false;
+            }
+
+            // The combined multi-timbral processor has no parameters to address
+            if (options.oscPort > 0 && dynamic_cast<MultiTimbralProcessor*>(plugin.get()) != nullptr)
+            {
+                std::cout << "[ERROR] --osc-port: OSC control needs single-instance mode (--timbres 1)" << std::endl;
+                return false;
+            }
+
+            // A single instance plays through a HotSwapProcessor so it can be hot-reloaded
+            if (dynamic_cast<AudioPluginInstance*>(plugin.get()) != nullptr)
+                hotSwap = std::make_unique<HotSwapProcessor>(*plugin, options.reloadFadeMs);
+
             // Connect plugin to player
-            player.setProcessor(plugin.get());
+            player.setProcessor(&getPlayedProcessor());
             std::cout << "Plugin connected to audio player." << std::endl;
 
+            // Connect audio player to audio device (after the plugin, so the
+            // realtime warm-up runs against a prepared processor)
+            AudioIODeviceCallback* callbackChain = &player;
+
+            // Innermost: apply coalesced network parameter changes once per block
+            parameterTable = std::make_unique<ParameterChangeTable>(plugin->getParameters().size());
+            auto applyParameter = hotSwap
+                ? ParameterTableCallback::ApplyFn([swap = hotSwap.get()](int index, float value) { swap->setCurrentParameter(index, value); })
+                : ParameterTableCallback::setValueOn(*plugin);
+            parameterTableCallback = std::make_unique<ParameterTableCallback>(*callbackChain, *parameterTable, std::move(applyParameter));
+            callbackChain = parameterTableCallback.get();
+
+            if (options.realtime.enabled)
+            {
+                realtimeCallback = std::make_unique<RealtimeAudioCallback>(*callbackChain, &getPlayedProcessor(), options.realtime);
+                callbackChain = realtimeCallback.get();
+            }
+
+            if (options.audioTapPort > 0)
+            {
+                audioTap = std::make_unique<UDPAudioTap>(*callbackChain);
+                if (audioTap->start(options.audioTapPort))
+                    callbackChain = audioTap.get();
+                else
+                    audioTap.reset();
+            }
+
+            // Outermost wrapper times the whole callback against its deadline
+            callbackMonitor = std::make_unique<CallbackMonitor>(*callbackChain);
+            deviceManager.addAudioCallback(callbackMonitor.get());
+            std::cout << "Audio player connected to device." << std::endl;
+
             // Print plugin parameters
             int numParams = plugin->getNumParameters();
             std::cout << "\nPlugin parameters (" << numParams << " total):" << std::endl;
@@ -593,10 +1052,17 @@ public:
                 std::cout << "  " << i << ": " << paramName << " = " << paramValue << std::endl;
             }
 
+            if (options.oscPort > 0)
+            {
+                oscReceiver = std::make_unique<OSCParameterReceiver>(*plugin, *parameterTable);
+                if (!oscReceiver->start(options.oscPort, options.oscBindAddress))
+                    oscReceiver.reset();
+            }
+
             // Setup UDP MIDI receiver for Python bridge
             std::cout << "\nStarting UDP MIDI receiver..." << std::endl;
-            udpMidiReceiver = std::make_unique<UDPMIDIReceiver>(midiCollector);
-            if (!udpMidiReceiver->start(9999))
+            udpMidiReceiver = std::make_unique<UDPMIDIReceiver>(player.getMidiMessageCollector());
+            if (!udpMidiReceiver->start(9999, options.realtime.udpCpu))
             {
                 std::cout << "WARNING: UDP MIDI receiver failed to start" << std::endl;
             }
@@ -616,15 +1082,30 @@ public:
         {
             std::cout << "\nShutting down..." << std::endl;
 
+            // Stop MIDI sources first so nothing feeds the player while it is torn down
+            if (udpMidiReceiver)
+                udpMidiReceiver->stop();
+            oscReceiver.reset();
+
             // Stop audio callbacks in correct order
-            deviceManager.removeAudioCallback(&player);
+            deviceManager.removeAudioCallback(callbackMonitor.get());
             deviceManager.removeMidiInputDeviceCallback({}, &player);
+            deviceManager.closeAudioDevice();
 
             // Clear processor before destroying plugin
             player.setProcessor(nullptr);
 
             // Destroy plugin
+            hotSwap.reset();
+            parameterLookups.clear();
             plugin.reset();
+            callbackMonitor.reset();
+            audioTap.reset();
+            realtimeCallback.reset();
+            parameterTableCallback.reset();
+
+            if (options.realtime.enabled)
+                RealtimeProfile::unlockMemory();
 
             std::cout << "Shutdown complete." << std::endl;
         }
@@ -639,37 +1120,313 @@ public:
         std::cout << "========================================" << std::endl;
         std::cout << "SimpleSynth is ready!" << std::endl;
         std::cout << "Send MIDI notes to play the synth." << std::endl;
-        std::cout << "Press Ctrl+C to exit." << std::endl;
+        std::cout << "Press Ctrl+C (or send SIGTERM) to exit." << std::endl;
         std::cout << "========================================\n" << std::endl;
 
-        // Keep running until interrupted
-        while (true)
+        if (realtimeCallback)
+        {
+            // Give the device a moment to run its first callback
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            std::cout << "Realtime profile: SCHED_FIFO "
+                      << (realtimeCallback->isRealtime() ? "granted" : "DENIED (check RLIMIT_RTPRIO)")
+                      << ", audio CPU " << (realtimeCallback->isPinned() ? String(options.realtime.audioCpu) : String("unpinned"))
+                      << std::endl;
+        }
+
+        // Sleep until a signal, control command or stats tick arrives
+        eventLoop = std::make_unique<HostEventLoop>(options.controlSocketPath, options.statsInterval);
+        eventLoop->run([this](const String& command) { return handleControlCommand(command); },
+                       [this] { reportStats(); });
+
+        // A hot reload still in flight completes its swap before the loop goes
+        // away; each step posts the next, or the outcome, before its thread ends
+        while (reloading)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (reloadThread.joinable())
+                reloadThread.join();
+            eventLoop->dispatchPending();
         }
 
+        if (reloadThread.joinable())
+            reloadThread.join();
+        eventLoop.reset();
+
         return 0;
     }
 
+    // Control socket commands, one per line (e.g. `echo stats | nc -U <path>`)
+    String handleControlCommand(const String& command)
+    {
+        auto tokens = StringArray::fromTokens(command, false);
+        auto verb = tokens[0].toLowerCase();
+
+        if (verb == "stats")
+        {
+            auto stats = callbackMonitor ? callbackMonitor->getSnapshot() : CallbackMonitor::Snapshot();
+            if (tokens[1] == "json")
+                return JSON::toString(stats.toJson(), true);
+
+            auto text = stats.toText();
+            if (oscReceiver)
+                text << "\n[osc] updates=" << (int64) parameterTable->getNumWrites()
+                     << " applied=" << (int64) parameterTable->getNumApplied()
+                     << " unknown=" << oscReceiver->getNumUnknownAddresses()
+                     << " rejected=" << oscReceiver->getNumRejectedArguments();
+            if (AudioCallbackGuard::isEnabled())
+                text << "\n[guard] audio-thread allocations=" << (int64) AudioCallbackGuard::getAllocationCount();
+            if (auto* multi = dynamic_cast<MultiTimbralProcessor*>(plugin.get()))
+                text << "\n[timbres] late renders=" << multi->getNumLateRenders()
+                     << " dropped midi=" << multi->getNumDroppedMidiEvents();
+            return text;
+        }
+
+        if (verb == "reload")
+        {
+            if (reloading)
+                return "error: a hot reload is in progress";
+
+            StringArray errors;
+            int applied = applyConfiguredParameters(parameterLookups, options, errors);
+            if (!errors.isEmpty())
+                return "error: " + errors.joinIntoString("; ");
+            return "ok: reapplied " + String(applied) + " parameter(s)";
+        }
+
+        if (verb == "reset")
+        {
+            // Same lock the player holds around processBlock, so this lands between blocks
+            auto& played = getPlayedProcessor();
+            const ScopedLock sl(played.getCallbackLock());
+            played.reset();
+            return "ok: voices reset";
+        }
+
+        if (verb == "hotreload")
+            return hotReload(command.fromFirstOccurrenceOf(" ", false, false).trim().unquoted());
+
+        if (verb == "quit")
+        {
+            eventLoop->requestStop();
+            return "ok: shutting down";
+        }
+
+        return "commands: stats [json] | reload | reset | hotreload [path.vst3] | quit";
+    }
+
+    // Loads a new build of the plugin and crossfades to it without stopping the
+    // device. The command replies at once and the reload runs in three steps:
+    //   1. reloadThread copies the bundle to a staging directory
+    //   2. the event-loop thread creates the instance from it and restores the
+    //      state; instances are only ever created here, the thread that created
+    //      the first one, because off that thread JUCE would hand creation to a
+    //      message loop this host doesn't run
+    //   3. reloadThread prepares it, hands it to the audio thread and waits out
+    //      the crossfade, then posts the finished swap back to the event loop,
+    //      which owns the instances and prints the result
+    String hotReload(const String& path)
+    {
+        if (!hotSwap)
+            return "error: hot reload needs single-instance mode";
+
+        if (reloading)
+            return "error: a hot reload is already in progress";
+
+        auto* device = deviceManager.getCurrentAudioDevice();
+        if (device == nullptr)
+            return "error: no audio device";
+
+        File source = path.isNotEmpty() ? File(path) : getDefaultPluginFile();
+        if (!source.isDirectory())
+            return "error: plugin not found at " + source.getFullPathName();
+
+        MemoryBlock state;
+        plugin->getStateInformation(state);
+
+        if (reloadThread.joinable())
+            reloadThread.join();
+
+        reloading = true;
+        reloadThread = std::thread([this, source, state,
+                                    rate = (int) device->getCurrentSampleRate(),
+                                    blockSize = device->getCurrentBufferSizeSamples(),
+                                    startTime = Time::getMillisecondCounterHiRes()]
+        {
+            stageReplacement(source, state, rate, blockSize, startTime);
+        });
+
+        return "ok: reloading " + source.getFileName();
+    }
+
+    // Event-loop thread
+    void finishFailedReload(const String& message)
+    {
+        std::cout << "[ERROR] Hot reload: " << message << std::endl;
+        reloading = false;
+    }
+
+    // Reload thread, step 1. Ends by posting step 2, or the failure, to the event loop.
+    void stageReplacement(const File& source, const MemoryBlock& state, int rate, int blockSize, double startTime)
+    {
+        // JUCE caches VST3 modules by path, so load the new build from a fresh copy
+        auto staging = File::getSpecialLocation(File::tempDirectory)
+                           .getNonexistentChildFile("SimpleSynth-reload", ".vst3", false);
+        if (!source.copyDirectoryTo(staging))
+        {
+            eventLoop->post([this, source] { finishFailedReload("could not stage " + source.getFullPathName()); });
+            return;
+        }
+
+        eventLoop->post([this, staging, source, state, rate, blockSize, startTime]
+        {
+            createReplacement(staging, source, state, rate, blockSize, startTime);
+        });
+    }
+
+    // Event-loop thread, step 2: creates the instance and starts step 3
+    void createReplacement(const File& staging, const File& source, const MemoryBlock& state,
+                           int rate, int blockSize, double startTime)
+    {
+        std::unique_ptr<AudioProcessor> next = loadPluginFromFile(staging, rate, blockSize);
+        if (!next)
+        {
+            staging.deleteRecursively();
+            return finishFailedReload("failed to load " + source.getFullPathName());
+        }
+
+        next->setStateInformation(state.getData(), (int) state.getSize());
+        next->enableAllBuses();
+
+        // Step 1 posted this as its last action, so its thread is finishing
+        if (reloadThread.joinable())
+            reloadThread.join();
+
+        reloadThread = std::thread([this, instance = std::move(next), staging, source, rate, blockSize, startTime]() mutable
+        {
+            swapInReplacement(std::move(instance), staging, source, rate, blockSize, startTime);
+        });
+    }
+
+    // Reload thread, step 3. Ends by posting the finished swap to the event loop.
+    void swapInReplacement(std::unique_ptr<AudioProcessor> next, const File& staging, const File& source,
+                           int rate, int blockSize, double startTime)
+    {
+        next->setNonRealtime(false);
+        next->setRateAndBufferSizeDetails(rate, blockSize);
+        next->prepareToPlay(rate, blockSize);
+
+        hotSwap->beginSwap(next.get());
+
+        // Wait for the audio thread to finish the crossfade; if the device has
+        // stopped calling back, complete the swap under the callback lock instead
+        AudioProcessor* retired = nullptr;
+        auto deadline = Time::getMillisecondCounterHiRes() + options.reloadFadeMs + 1000.0;
+        while ((retired = hotSwap->takeRetired()) == nullptr)
+        {
+            if (Time::getMillisecondCounterHiRes() > deadline)
+            {
+                hotSwap->finishSwapNow();
+                retired = hotSwap->takeRetired();
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        // std::function needs a copyable callback, so the new instance travels in a shared_ptr
+        auto ready = std::make_shared<std::unique_ptr<AudioProcessor>>(std::move(next));
+
+        eventLoop->post([this, ready, retired, staging, source, startTime]
+        {
+            jassert(retired == plugin.get());
+            ignoreUnused(retired);
+
+            std::swap(plugin, *ready);
+            parameterLookups = createParameterLookups(*plugin);
+
+            // The new build may have different parameters: remap OSC onto a fresh table
+            if (oscReceiver)
+            {
+                auto table = std::make_unique<ParameterChangeTable>(plugin->getParameters().size());
+                oscReceiver->setParameters(*plugin, *table);
+                {
+                    const ScopedLock sl(deviceManager.getAudioCallbackLock());
+                    parameterTableCallback->setTable(*table);
+                }
+                parameterTable = std::move(table);
+            }
+
+            // Old instance is out of the audio path now; destroy it here
+            (*ready)->releaseResources();
+            ready->reset();
+
+            if (stagedPluginDir.exists())
+                stagedPluginDir.deleteRecursively();
+            stagedPluginDir = staging;
+
+            std::cout << "[*] Hot reload: reloaded " << source.getFileName() << " in "
+                      << String(Time::getMillisecondCounterHiRes() - startTime, 1) << " ms" << std::endl;
+            reloading = false;
+        });
+    }
+
+    void reportStats()
+    {
+        if (!callbackMonitor)
+            return;
+
+        auto stats = callbackMonitor->getSnapshot();
+
+        if (options.statsJsonPath.isEmpty())
+        {
+            std::cout << stats.toText() << std::endl;
+            return;
+        }
+
+        auto json = JSON::toString(stats.toJson(), true);
+
+        if (options.statsJsonPath == "-")
+            std::cout << json << std::endl;
+        else
+            File(options.statsJsonPath).replaceWithText(json + "\n");
+    }
+
 private:
     AudioDeviceManager deviceManager;
     AudioPluginFormatManager formatManager;
     AudioProcessorPlayer player;
-    std::unique_ptr<AudioPluginInstance> plugin;
+    std::unique_ptr<AudioProcessor> plugin;
+    std::unique_ptr<HotSwapProcessor> hotSwap;
+    ParameterLookups parameterLookups;  // For the current plugin; rebuilt after a hot reload
+    File stagedPluginDir;                // Copy the current hot-reloaded build was loaded from
+    std::thread reloadThread;            // Stages, then prepares and swaps in, the next build
+    bool reloading = false;              // Event-loop thread only
     std::unique_ptr<UDPMIDIReceiver> udpMidiReceiver;
-    MidiMessageCollector midiCollector;
+    std::unique_ptr<ParameterChangeTable> parameterTable;
+    std::unique_ptr<ParameterTableCallback> parameterTableCallback;
+    std::unique_ptr<OSCParameterReceiver> oscReceiver;
+    CommandLineOptions options;
+    std::unique_ptr<RealtimeAudioCallback> realtimeCallback;
+    std::unique_ptr<UDPAudioTap> audioTap;
+    std::unique_ptr<CallbackMonitor> callbackMonitor;
+    std::unique_ptr<HostEventLoop> eventLoop;
+
+    AudioProcessor& getPlayedProcessor()
+    {
+        return hotSwap ? static_cast<AudioProcessor&>(*hotSwap) : *plugin;
+    }
 };
 
 // Helper function to load SimpleSynth VST3 plugin
-std::unique_ptr<AudioPluginInstance> loadSimpleSynthPlugin(int sampleRate, int blockSize)
+File getDefaultPluginFile()
+{
+    String cwd = File::getCurrentWorkingDirectory().getFullPathName();
+    return File(cwd + "/SimpleSynth/cmake-build/SimpleSynth_artefacts/Debug/VST3/SimpleSynth.vst3");
+}
+
+std::unique_ptr<AudioPluginInstance> loadPluginFromFile(const File& vst3File, int sampleRate, int blockSize)
 {
     AudioPluginFormatManager formatManager;
     formatManager.addFormat(new VST3PluginFormat());
 
-    String cwd = File::getCurrentWorkingDirectory().getFullPathName();
-    String pluginPath = cwd + "/SimpleSynth/cmake-build/SimpleSynth_artefacts/Debug/VST3/SimpleSynth.vst3";
-    File vst3File(pluginPath);
-
     // VST3 is a directory bundle, check if directory exists
     if (!vst3File.exists() || !vst3File.isDirectory())
     {
@@ -705,18 +1462,55 @@ std::unique_ptr<AudioPluginInstance> loadSimpleSynthPlugin(int sampleRate, int b
     return plugin;
 }
 
+std::unique_ptr<AudioPluginInstance> loadSimpleSynthPlugin(int sampleRate, int blockSize)
+{
+    return loadPluginFromFile(getDefaultPluginFile(), sampleRate, blockSize);
+}
+
 // Main entry point
 int main(int argc, char* argv[])
 {
     // Parse command-line options
     CommandLineOptions opts = CommandLineOptions::parse(argc, argv);
 
-    // Load SimpleSynth plugin
-    auto plugin = loadSimpleSynthPlugin(opts.sampleRate, opts.blockSize);
-    if (!plugin)
+    // Interactive mode handles SIGINT/SIGTERM in its event loop; block them before
+    // the plugin or audio device start any threads
+    if (!opts.batchMode)
+        HostEventLoop::blockTerminationSignals();
+
+    // Load SimpleSynth plugin (one instance per MIDI channel in multi-timbral mode)
+    std::unique_ptr<AudioProcessor> plugin;
+
+    if (opts.numTimbres > 1)
+    {
+        std::vector<std::unique_ptr<AudioPluginInstance>> instances;
+        for (int i = 0; i < opts.numTimbres; ++i)
+        {
+            auto instance = loadSimpleSynthPlugin(opts.sampleRate, opts.blockSize);
+            if (!instance)
+            {
+                std::cerr << "Failed to load SimpleSynth plugin." << std::endl;
+                return 1;
+            }
+            instances.push_back(std::move(instance));
+        }
+
+        int workers = opts.renderThreads >= 0
+            ? opts.renderThreads
+            : jmax(0, SystemStats::getNumCpus() - 1);
+        auto multi = std::make_unique<MultiTimbralProcessor>(std::move(instances), workers, opts.realtime);
+        std::cerr << "[SimpleSynthHost] Multi-timbral: " << multi->getNumInstances() << " instances, "
+                  << multi->getNumWorkers() << " render worker(s)" << std::endl;
+        plugin = std::move(multi);
+    }
+    else
     {
-        std::cerr << "Failed to load SimpleSynth plugin." << std::endl;
-        return 1;
+        plugin = loadSimpleSynthPlugin(opts.sampleRate, opts.blockSize);
+        if (!plugin)
+        {
+            std::cerr << "Failed to load SimpleSynth plugin." << std::endl;
+            return 1;
+        }
     }
 
     // Choose mode
@@ -730,7 +1524,10 @@ int main(int argc, char* argv[])
     else
     {
         // Interactive mode - UDP MIDI receiver
-        SimpleSynthHost host(std::move(plugin));
+        if (opts.automationPath.isNotEmpty())
+            std::cout << "WARNING: --automation only applies to batch rendering; use OSC for live control" << std::endl;
+
+        SimpleSynthHost host(std::move(plugin), opts);
 
         if (!host.initialise())
         {
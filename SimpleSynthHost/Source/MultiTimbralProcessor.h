@@ -0,0 +1,270 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "AudioCallbackGuard.h"
+#include "ParallelRenderPool.h"
+
+// Hosts N plugin instances as one processor: instance i plays MIDI channel i + 1.
+// Incoming MIDI is split by channel into preallocated per-instance buffers, the
+// instances render in parallel on a ParallelRenderPool, and their outputs are
+// summed. Channels beyond the number of instances are dropped; non-channel
+// messages go to every instance.
+//
+// In real time the audio thread waits at most one block's duration for the
+// workers, across both the wait for an earlier block and the render itself.
+// An instance that isn't done by then is left out of the mix, and a block
+// arriving while it is still rendering is output silent; its MIDI is held back
+// and delivered at the start of the next block that renders, so no note-offs
+// are lost. Events that don't fit a preallocated MIDI buffer are dropped rather
+// than allocated for. Both are counted.
+class MultiTimbralProcessor : public juce::AudioProcessor
+{
+public:
+    static constexpr int midiBufferReserveBytes = 4096;
+
+    // What MidiBuffer stores per event besides the message: its sample position and size
+    static constexpr int midiEventHeaderBytes = (int) (sizeof(juce::int32) + sizeof(juce::uint16));
+
+    MultiTimbralProcessor(std::vector<std::unique_ptr<juce::AudioPluginInstance>> pluginInstances,
+                          int numWorkerThreads,
+                          const RealtimeProfile& rtProfile = {})
+        : AudioProcessor(BusesProperties()
+              .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          instances(std::move(pluginInstances)),
+          pool(juce::jmin(numWorkerThreads, juce::jmax(0, (int) instances.size() - 1)), rtProfile),
+          timbres(instances.size()),
+          renderJob { *this }
+    {
+        for (auto& instance : instances)
+            instance->enableAllBuses();
+    }
+
+    ~MultiTimbralProcessor() override
+    {
+        pool.waitUntilIdle(-1);
+    }
+
+    int getNumInstances() const { return (int) instances.size(); }
+    juce::AudioPluginInstance& getInstance(int index) { return *instances[(size_t) index]; }
+    int getNumWorkers() const { return pool.getNumWorkers(); }
+
+    // Instance renders left out of the mix, and MIDI events dropped, since the start
+    int getNumLateRenders() const { return lateRenders.load(std::memory_order_relaxed); }
+    int getNumDroppedMidiEvents() const { return droppedMidiEvents.load(std::memory_order_relaxed); }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override
+    {
+        const int numChannels = juce::jmax(2, getTotalNumOutputChannels());
+
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            auto& instance = *instances[i];
+            instance.setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+            instance.prepareToPlay(sampleRate, samplesPerBlock);
+
+            auto& timbre = timbres[i];
+            timbre.buffer.setSize(juce::jmax(numChannels,
+                                             instance.getTotalNumInputChannels(),
+                                             instance.getTotalNumOutputChannels()),
+                                  samplesPerBlock, false, true, false);
+            timbre.midi.ensureSize(midiBufferReserveBytes);
+        }
+
+        heldBackMidi.ensureSize(midiBufferReserveBytes);
+        heldBackMidi.clear();
+    }
+
+    void releaseResources() override
+    {
+        pool.waitUntilIdle(-1);
+
+        for (auto& instance : instances)
+            instance->releaseResources();
+    }
+
+    void reset() override
+    {
+        for (auto& instance : instances)
+        {
+            const juce::ScopedLock sl(instance->getCallbackLock());
+            instance->reset();
+        }
+    }
+
+    void setNonRealtime(bool isNonRealtime) noexcept override
+    {
+        AudioProcessor::setNonRealtime(isNonRealtime);
+        for (auto& instance : instances)
+            instance->setNonRealtime(isNonRealtime);
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int numInstances = (int) instances.size();
+
+        // One block's worth of time shared by both waits below, offline as long as it takes
+        const bool realtime = !isNonRealtime();
+        const auto deadline = juce::Time::getMillisecondCounter()
+                            + (juce::uint32) juce::jmax(1, (int) (numSamples * 1000.0 / getSampleRate()));
+        auto remainingMs = [&]
+        {
+            const auto now = juce::Time::getMillisecondCounter();
+            return realtime ? (now < deadline ? (int) (deadline - now) : 0) : -1;
+        };
+
+        buffer.clear();
+
+        // An instance from an earlier block is still rendering into its buffers,
+        // so keep this block's MIDI for the next one
+        if (!pool.waitUntilIdle(remainingMs()))
+        {
+            lateRenders.fetch_add(1, std::memory_order_relaxed);
+
+            for (const auto metadata : midiMessages)
+                holdBackMidiEvent(metadata.getMessage());
+
+            return;
+        }
+
+        for (auto& timbre : timbres)
+        {
+            timbre.midi.clear();
+            timbre.rendered.store(false, std::memory_order_relaxed);
+        }
+
+        // Held-back events first, at the start of the block, so they keep their order
+        for (const auto metadata : heldBackMidi)
+            distributeMidiEvent(metadata.getMessage(), 0);
+
+        heldBackMidi.clear();
+
+        for (const auto metadata : midiMessages)
+            distributeMidiEvent(metadata.getMessage(), metadata.samplePosition);
+
+        renderJob.numSamples = numSamples;
+        pool.run(numInstances, renderJob, remainingMs());
+
+        for (auto& timbre : timbres)
+        {
+            if (!timbre.rendered.load(std::memory_order_acquire))
+            {
+                lateRenders.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.addFrom(ch, 0, timbre.buffer, juce::jmin(ch, timbre.buffer.getNumChannels() - 1), 0, numSamples);
+        }
+    }
+
+    double getTailLengthSeconds() const override
+    {
+        double tail = 0.0;
+        for (auto& instance : instances)
+            tail = juce::jmax(tail, instance->getTailLengthSeconds());
+        return tail;
+    }
+
+    const juce::String getName() const override { return "SimpleSynth x" + juce::String((int) instances.size()); }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    struct Timbre
+    {
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        std::atomic<bool> rendered { false };  // Set by the thread that rendered this block
+    };
+
+    // A member rather than a lambda in processBlock: a late worker may still be
+    // running it after processBlock has returned
+    struct RenderJob
+    {
+        MultiTimbralProcessor& owner;
+        int numSamples = 0;
+
+        void operator()(int index)
+        {
+            AudioCallbackGuard::ScopedAudioCallback audioCallback;  // Workers are outside the device callback's scope
+            auto& timbre = owner.timbres[(size_t) index];
+            juce::AudioBuffer<float> block(timbre.buffer.getArrayOfWritePointers(),
+                                           timbre.buffer.getNumChannels(), numSamples);
+            block.clear();
+
+            auto& instance = *owner.instances[(size_t) index];
+            {
+                const juce::ScopedLock sl(instance.getCallbackLock());
+
+                if (!instance.isSuspended())
+                    instance.processBlock(block, timbre.midi);
+            }
+
+            timbre.rendered.store(true, std::memory_order_release);
+        }
+    };
+
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+    ParallelRenderPool pool;
+    std::vector<Timbre> timbres;
+    juce::MidiBuffer heldBackMidi;  // MIDI from blocks output silent, for the next block that renders
+    RenderJob renderJob;
+
+    std::atomic<int> lateRenders { 0 };
+    std::atomic<int> droppedMidiEvents { 0 };
+
+    void distributeMidiEvent(const juce::MidiMessage& msg, int samplePosition)
+    {
+        const int channel = msg.getChannel();  // 0 for non-channel messages
+
+        if (channel == 0)
+        {
+            for (auto& timbre : timbres)
+                addMidiEvent(timbre, msg, samplePosition);
+        }
+        else if (channel <= (int) timbres.size())
+        {
+            addMidiEvent(timbres[(size_t) (channel - 1)], msg, samplePosition);
+        }
+    }
+
+    void holdBackMidiEvent(const juce::MidiMessage& msg)
+    {
+        if (heldBackMidi.data.size() + midiEventHeaderBytes + msg.getRawDataSize() > midiBufferReserveBytes)
+        {
+            droppedMidiEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        heldBackMidi.addEvent(msg, 0);
+    }
+
+    void addMidiEvent(Timbre& timbre, const juce::MidiMessage& msg, int samplePosition)
+    {
+        if (timbre.midi.data.size() + midiEventHeaderBytes + msg.getRawDataSize() > midiBufferReserveBytes)
+        {
+            droppedMidiEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        timbre.midi.addEvent(msg, samplePosition);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiTimbralProcessor)
+};
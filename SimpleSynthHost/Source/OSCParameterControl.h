@@ -0,0 +1,285 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_osc/juce_osc.h>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ParameterLookup.h"
+
+// Last-value-wins parameter table shared between a network thread and the audio
+// thread. Writers overwrite a slot and mark it dirty; the audio thread drains the
+// dirty slots once per block, so thousands of updates per second collapse into at
+// most one parameter change per parameter per block.
+class ParameterChangeTable
+{
+public:
+    explicit ParameterChangeTable(int numParameters)
+        : slots(std::make_unique<Slot[]>((size_t) juce::jmax(1, numParameters))),
+          numSlots(numParameters)
+    {
+    }
+
+    // Any thread
+    void set(int index, float normalisedValue) noexcept
+    {
+        if (!juce::isPositiveAndBelow(index, numSlots))
+            return;
+
+        slots[(size_t) index].value.store(juce::jlimit(0.0f, 1.0f, normalisedValue), std::memory_order_relaxed);
+        slots[(size_t) index].dirty.store(true, std::memory_order_release);
+        anyDirty.store(true, std::memory_order_release);
+        writes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Audio thread: calls apply(index, value) for every slot written since the last drain
+    template <typename ApplyFn>
+    void drain(ApplyFn&& apply) noexcept
+    {
+        if (!anyDirty.exchange(false, std::memory_order_acquire))
+            return;
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            auto& slot = slots[(size_t) i];
+            if (slot.dirty.exchange(false, std::memory_order_acquire))
+            {
+                apply(i, slot.value.load(std::memory_order_relaxed));
+                applied.store(applied.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    int size() const noexcept { return numSlots; }
+    juce::uint64 getNumWrites() const noexcept { return writes.load(std::memory_order_relaxed); }
+    juce::uint64 getNumApplied() const noexcept { return applied.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<float> value { 0.0f };
+        std::atomic<bool> dirty { false };
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    const int numSlots;
+    std::atomic<bool> anyDirty { false };
+    std::atomic<juce::uint64> writes { 0 };
+    std::atomic<juce::uint64> applied { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterChangeTable)
+};
+
+// Applies pending table entries right before each block. The apply function
+// should use AudioProcessorParameter::setValue (not setValueNotifyingHost) so
+// host listeners and edit-controller notifications stay off the audio thread.
+class ParameterTableCallback : public juce::AudioIODeviceCallback
+{
+public:
+    using ApplyFn = std::function<void(int parameterIndex, float normalisedValue)>;
+
+    ParameterTableCallback(juce::AudioIODeviceCallback& targetCallback,
+                           ParameterChangeTable& changeTable,
+                           ApplyFn applyParameter)
+        : target(targetCallback), table(&changeTable), apply(std::move(applyParameter))
+    {
+    }
+
+    // Points the callback at another table, e.g. one sized for a hot-reloaded
+    // plugin. Call with the device's audio callback lock held.
+    void setTable(ParameterChangeTable& changeTable)
+    {
+        table = &changeTable;
+    }
+
+    // Plain setValue on a processor whose parameters never change
+    static ApplyFn setValueOn(juce::AudioProcessor& processor)
+    {
+        return [params = processor.getParameters()](int index, float value)
+        {
+            if (auto* param = params[index])
+                param->setValue(value);
+        };
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+    {
+        target.audioDeviceAboutToStart(device);
+    }
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override
+    {
+        table->drain(apply);
+
+        target.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                outputChannelData, numOutputChannels,
+                                                numSamples, context);
+    }
+
+    void audioDeviceStopped() override
+    {
+        target.audioDeviceStopped();
+    }
+
+    void audioDeviceError(const juce::String& errorMessage) override
+    {
+        target.audioDeviceError(errorMessage);
+    }
+
+private:
+    juce::AudioIODeviceCallback& target;
+    ParameterChangeTable* table;
+    ApplyFn apply;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterTableCallback)
+};
+
+// OSC-over-UDP endpoint mapping /synth/<parameter> to plugin parameters.
+// Addresses use the plugin's parameter ID (/synth/glideMode) or the lower-cased
+// display name with spaces as underscores (/synth/gain, /synth/ping_pong). A
+// float argument is the normalised 0..1 value; an int argument is a step index
+// and only accepted by discrete parameters (waveform, glide mode). Messages are
+// handled on the receiver's own thread and only ever touch the change table.
+// After a hot reload, setParameters() remaps the addresses to the new plugin.
+class OSCParameterReceiver : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+{
+public:
+    OSCParameterReceiver(juce::AudioProcessor& processor, ParameterChangeTable& changeTable,
+                         const juce::String& oscAddressPrefix = "/synth/")
+        : addressPrefix(oscAddressPrefix)
+    {
+        setParameters(processor, changeTable);
+    }
+
+    ~OSCParameterReceiver() override
+    {
+        stop();
+    }
+
+    // Listens on bindAddress only: loopback unless another interface is asked for
+    bool start(int port, const juce::String& bindAddress = "127.0.0.1")
+    {
+        socket = std::make_unique<juce::DatagramSocket>(false);
+
+        if (!socket->bindToPort(port, bindAddress) || !receiver.connectToSocket(*socket))
+        {
+            std::cout << "[ERROR] Failed to bind OSC receiver to " << bindAddress << ":" << port << std::endl;
+            socket.reset();
+            return false;
+        }
+
+        receiver.addListener(this);
+        std::cout << "[*] OSC parameter control listening on " << bindAddress << ":" << port << std::endl;
+        return true;
+    }
+
+    void stop()
+    {
+        receiver.removeListener(this);
+        receiver.disconnect();
+        socket.reset();
+    }
+
+    // Rebuilds the address map from processor's parameters and writes to changeTable
+    // from now on. Safe while listening; a message being handled finishes first.
+    void setParameters(juce::AudioProcessor& processor, ParameterChangeTable& changeTable)
+    {
+        juce::HashMap<juce::String, int> newAddresses;
+        std::vector<int> newStepCounts;
+
+        auto& params = processor.getParameters();
+        for (int i = 0; i < params.size(); ++i)
+        {
+            auto name = params[i]->getName(128).trim().toLowerCase().replaceCharacter(' ', '_');
+            newAddresses.set(addressPrefix + name, i);
+
+            // Numeric VST3 ID, see ParameterLookup
+            if (auto* withId = dynamic_cast<juce::HostedAudioProcessorParameter*>(params[i]))
+                newAddresses.set(addressPrefix + withId->getParameterID(), i);
+
+            const int numSteps = params[i]->getNumSteps();
+            newStepCounts.push_back(params[i]->isDiscrete() && numSteps > 1 ? numSteps : 0);
+        }
+
+        const juce::ScopedLock sl(mappingLock);
+        addresses.swapWith(newAddresses);
+        stepCounts.swap(newStepCounts);
+        table = &changeTable;
+    }
+
+    int getNumUnknownAddresses() const { return unknownAddresses.load(); }
+    int getNumRejectedArguments() const { return rejectedArguments.load(); }
+
+private:
+    const juce::String addressPrefix;
+    std::unique_ptr<juce::DatagramSocket> socket;
+    juce::OSCReceiver receiver { "OSC parameter control" };
+    juce::CriticalSection mappingLock;  // Guards the three below against setParameters()
+    juce::HashMap<juce::String, int> addresses;
+    std::vector<int> stepCounts;  // Per parameter: number of steps if discrete, else 0
+    ParameterChangeTable* table = nullptr;
+    std::atomic<int> unknownAddresses { 0 };
+    std::atomic<int> rejectedArguments { 0 };
+
+    int findParameter(const juce::String& address) const
+    {
+        if (addresses.contains(address))
+            return addresses[address];
+
+        // Not a display name: try it as a string ID, which the host only knows hashed
+        if (address.startsWith(addressPrefix))
+        {
+            auto hashed = addressPrefix + ParameterLookup::getVst3ParameterID(address.substring(addressPrefix.length()));
+            if (addresses.contains(hashed))
+                return addresses[hashed];
+        }
+
+        return -1;
+    }
+
+    void oscMessageReceived(const juce::OSCMessage& message) override
+    {
+        if (message.size() < 1)
+            return;
+
+        const juce::ScopedLock sl(mappingLock);
+        const int index = findParameter(message.getAddressPattern().toString());
+        if (index < 0)
+        {
+            ++unknownAddresses;
+            return;
+        }
+
+        const auto& arg = message[0];
+        const int numSteps = stepCounts[(size_t) index];
+
+        if (arg.isFloat32())
+            table->set(index, juce::jlimit(0.0f, 1.0f, arg.getFloat32()));
+        else if (arg.isInt32() && numSteps > 0)
+            table->set(index, (float) juce::jlimit(0, numSteps - 1, (int) arg.getInt32()) / (float) (numSteps - 1));
+        else
+            ++rejectedArguments;
+    }
+
+    void oscBundleReceived(const juce::OSCBundle& bundle) override
+    {
+        for (auto& element : bundle)
+        {
+            if (element.isMessage())
+                oscMessageReceived(element.getMessage());
+            else if (element.isBundle())
+                oscBundleReceived(element.getBundle());
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(OSCParameterReceiver)
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <vector>
+
+#include "RealtimeProfile.h"
+
+// Small fixed pool for fanning independent jobs out within one audio callback.
+// The calling (audio) thread takes part in the work, so with N jobs and N-1
+// workers no thread ever waits for more than one job. Jobs are handed out from
+// an atomic counter; nothing allocates per run.
+//
+// Waiting for the workers is bounded: the caller spins briefly, then sleeps on
+// an event until a timeout. A batch still running after that is left to
+// finish on its own, and the next batch can't start until it has.
+class ParallelRenderPool
+{
+public:
+    ParallelRenderPool(int numWorkerThreads, const RealtimeProfile& rtProfile = {})
+        : profile(rtProfile)
+    {
+        for (int i = 0; i < numWorkerThreads; ++i)
+        {
+            workers.push_back(std::make_unique<Worker>(*this, i));
+            workers.back()->startThread(juce::Thread::Priority::highest);
+        }
+    }
+
+    ~ParallelRenderPool()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto& worker : workers)
+        {
+            worker->wake.signal();
+            worker->stopThread(2000);
+        }
+    }
+
+    int getNumWorkers() const { return (int) workers.size(); }
+
+    // True once every job of the last batch has finished, waiting up to
+    // timeoutMs for the stragglers (-1 = for ever)
+    bool waitUntilIdle(int timeoutMs)
+    {
+        const int numJobs = totalJobs.load(std::memory_order_relaxed);
+        auto isDone = [&] { return completedJobs.load(std::memory_order_acquire) >= numJobs; };
+
+        for (int spin = 0; spin < spinIterations; ++spin)
+            if (isDone())
+                return true;
+
+        const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) juce::jmax(0, timeoutMs);
+
+        while (!isDone())
+        {
+            const auto now = juce::Time::getMillisecondCounter();
+            if (timeoutMs >= 0 && now >= deadline)
+                return false;
+
+            batchDone.wait(timeoutMs < 0 ? -1 : (int) (deadline - now));
+        }
+
+        return true;
+    }
+
+    // Runs job(i) for every i in [0, numJobs). Returns true once all of them
+    // are done, or false if some are still running after timeoutMs; those carry
+    // on, so the job must outlive the call. The pool must be idle.
+    template <typename JobFn>
+    bool run(int numJobs, JobFn& job, int timeoutMs = -1)
+    {
+        jassert(completedJobs.load() >= totalJobs.load());
+
+        if (numJobs <= 0)
+            return true;
+
+        jobContext = &job;
+        jobFunction = [](void* context, int index) { (*static_cast<JobFn*>(context))(index); };
+        batchDone.reset();
+        totalJobs.store(numJobs, std::memory_order_relaxed);
+        completedJobs.store(0, std::memory_order_relaxed);
+        nextJob.store(0, std::memory_order_release);  // Publishes the job above
+
+        const int helpers = juce::jmin(numJobs - 1, (int) workers.size());
+        for (int i = 0; i < helpers; ++i)
+            workers[(size_t) i]->wake.signal();
+
+        runJobs();
+
+        // Every job has been claimed by now, so late wakers can't start one
+        nextJob.store(closedBatch, std::memory_order_relaxed);
+
+        return waitUntilIdle(timeoutMs);
+    }
+
+private:
+    struct Worker : public juce::Thread
+    {
+        Worker(ParallelRenderPool& ownerPool, int index)
+            : Thread("Render worker " + juce::String(index)), pool(ownerPool)
+        {
+        }
+
+        void run() override
+        {
+            if (pool.profile.enabled)
+                RealtimeProfile::setCurrentThreadRealtime(pool.profile.priority);
+
+            while (!threadShouldExit())
+            {
+                wake.wait(-1);
+                pool.runJobs();
+            }
+        }
+
+        ParallelRenderPool& pool;
+        juce::WaitableEvent wake;
+    };
+
+    RealtimeProfile profile;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    void* jobContext = nullptr;
+    void (*jobFunction)(void*, int) = nullptr;
+
+    // Far enough below INT_MAX that late wakers' fetch_adds can never wrap around
+    static constexpr int closedBatch = INT_MAX / 2;
+
+    // Checks of the completion count before the caller sleeps on batchDone
+    static constexpr int spinIterations = 256;
+
+    std::atomic<int> nextJob { closedBatch };
+    std::atomic<int> totalJobs { 0 };
+    std::atomic<int> completedJobs { 0 };
+    juce::WaitableEvent batchDone;  // Signalled by whichever thread finishes the last job
+
+    void runJobs()
+    {
+        for (;;)
+        {
+            const int index = nextJob.fetch_add(1, std::memory_order_acq_rel);
+            const int numJobs = totalJobs.load(std::memory_order_relaxed);
+            if (index >= numJobs)
+                return;
+
+            jobFunction(jobContext, index);
+
+            if (completedJobs.fetch_add(1, std::memory_order_acq_rel) + 1 == numJobs)
+                batchDone.signal();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(ParallelRenderPool)
+};
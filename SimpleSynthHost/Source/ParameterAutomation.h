@@ -0,0 +1,248 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "ParameterLookup.h"
+
+// Breakpoint automation read from a text file and played into a processor with
+// sample accuracy. Each line is "<seconds> <parameter> <value>" (whitespace or
+// comma separated, '#' starts a comment). Parameters and values use the same
+// syntax as --param, including the "<channel>:" prefix in multi-timbral mode.
+//
+// Continuous parameters ramp linearly between breakpoints; discrete ones
+// (waveform) step. The host block is split at every breakpoint, and every
+// rampInterval samples while a ramp is running, so each change reaches the
+// plugin at the sample it was scheduled for rather than at the next block.
+class ParameterAutomation
+{
+public:
+    static constexpr int rampInterval = 32;
+    static constexpr int midiBufferReserveBytes = 4096;
+
+    ParameterAutomation() = default;
+
+    // Returns false and fills 'errors' if the file can't be read or refers to
+    // parameters/values the processor doesn't have. The lookups come from
+    // createParameterLookups() and are only used while loading.
+    bool loadFromFile(const juce::File& file, const ParameterLookups& lookups, double sampleRate,
+                      juce::StringArray& errors)
+    {
+        if (!file.existsAsFile())
+        {
+            errors.add("cannot read " + file.getFullPathName());
+            return false;
+        }
+
+        juce::StringArray lines;
+        file.readLines(lines);
+
+        for (int lineNumber = 1; lineNumber <= lines.size(); ++lineNumber)
+        {
+            auto line = lines[lineNumber - 1].upToFirstOccurrenceOf("#", false, false).trim();
+            if (line.isEmpty())
+                continue;
+
+            juce::StringArray tokens;
+            tokens.addTokens(line, " \t,", "\"");
+            tokens.removeEmptyStrings();
+
+            auto where = file.getFileName() + ":" + juce::String(lineNumber) + ": ";
+
+            if (tokens.size() != 3 || !tokens[0].containsOnly("0123456789.") || !tokens[0].containsAnyOf("0123456789"))
+            {
+                errors.add(where + "expected '<seconds> <parameter> <value>'");
+                continue;
+            }
+
+            auto targets = resolveTargets(tokens[1], lookups, errors, where);
+            if (targets.empty())
+                continue;
+
+            float normalised = 0.0f;
+            if (!ParameterLookup::toNormalised(*targets.front(), tokens[2].unquoted(), normalised))
+            {
+                errors.add(where + "invalid value '" + tokens[2] + "' for '" + tokens[1] + "'");
+                continue;
+            }
+
+            auto samplePosition = (juce::int64) std::llround(tokens[0].getDoubleValue() * sampleRate);
+            for (auto* param : targets)
+                getOrCreateLane(*param).points.push_back({ samplePosition, normalised });
+        }
+
+        for (auto& lane : lanes)
+            std::stable_sort(lane.points.begin(), lane.points.end(),
+                             [](const Breakpoint& a, const Breakpoint& b) { return a.samplePosition < b.samplePosition; });
+
+        return errors.isEmpty();
+    }
+
+    int getNumLanes() const { return (int) lanes.size(); }
+
+    void prepare()
+    {
+        subBlockMidi.ensureSize(midiBufferReserveBytes);
+        position = 0;
+
+        for (auto& lane : lanes)
+        {
+            lane.nextPoint = 0;
+            lane.lastSent = -1.0f;
+        }
+    }
+
+    // Renders one host block as a series of sub-blocks, applying the automation
+    // values due at the start of each
+    void process(juce::AudioProcessor& processor, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+    {
+        const int numSamples = buffer.getNumSamples();
+        int start = 0;
+
+        while (start < numSamples)
+        {
+            const juce::int64 now = position + start;
+            juce::int64 end = position + numSamples;
+
+            for (auto& lane : lanes)
+            {
+                applyLane(lane, now);
+                end = std::min(end, lane.nextBoundary(now));
+            }
+
+            const int length = (int) (end - now);
+
+            juce::AudioBuffer<float> subBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, length);
+            subBlockMidi.clear();
+            subBlockMidi.addEvents(midiMessages, start, length, -start);
+
+            processor.processBlock(subBlock, subBlockMidi);
+            start += length;
+        }
+
+        position += numSamples;
+    }
+
+private:
+    struct Breakpoint
+    {
+        juce::int64 samplePosition;
+        float value;  // Normalised
+    };
+
+    // One per parameter of one instance, however the file spells it: "gain",
+    // "Gain" and "1:gain" all add breakpoints to the same lane, and at equal
+    // times the later line wins
+    struct Lane
+    {
+        juce::AudioProcessorParameter* target = nullptr;
+        std::vector<Breakpoint> points;
+        bool ramps = false;
+        size_t nextPoint = 0;  // First breakpoint after the current position
+        float lastSent = -1.0f;
+
+        float valueAt(juce::int64 samplePosition)
+        {
+            while (nextPoint < points.size() && points[nextPoint].samplePosition <= samplePosition)
+                ++nextPoint;
+
+            if (nextPoint == 0)
+                return points.front().value;  // Hold the first value until it's reached
+
+            const auto& previous = points[nextPoint - 1];
+            if (!ramps || nextPoint == points.size())
+                return previous.value;
+
+            const auto& next = points[nextPoint];
+            const double proportion = (double) (samplePosition - previous.samplePosition)
+                                    / (double) (next.samplePosition - previous.samplePosition);
+            return previous.value + (float) proportion * (next.value - previous.value);
+        }
+
+        juce::int64 nextBoundary(juce::int64 samplePosition) const
+        {
+            if (nextPoint >= points.size())
+                return std::numeric_limits<juce::int64>::max();
+
+            if (ramps && nextPoint > 0)
+                return std::min(points[nextPoint].samplePosition, samplePosition + rampInterval);
+
+            return points[nextPoint].samplePosition;
+        }
+    };
+
+    std::vector<Lane> lanes;
+    juce::int64 position = 0;
+    juce::MidiBuffer subBlockMidi;
+
+    void applyLane(Lane& lane, juce::int64 samplePosition)
+    {
+        const float value = lane.valueAt(samplePosition);
+        if (value == lane.lastSent)
+            return;
+
+        lane.target->setValue(value);
+        lane.lastSent = value;
+    }
+
+    Lane& getOrCreateLane(juce::AudioProcessorParameter& param)
+    {
+        for (auto& lane : lanes)
+            if (lane.target == &param)
+                return lane;
+
+        Lane lane;
+        lane.target = &param;
+        lane.ramps = !param.isDiscrete();
+        lanes.push_back(std::move(lane));
+        return lanes.back();
+    }
+
+    // The parameters a name refers to: one per instance, or only the instance
+    // playing its "<channel>:" prefix. Empty, with an error added, if unknown.
+    std::vector<juce::AudioProcessorParameter*> resolveTargets(const juce::String& name, const ParameterLookups& lookups,
+                                                               juce::StringArray& errors, const juce::String& where)
+    {
+        std::vector<juce::AudioProcessorParameter*> targets;
+
+        auto parameterName = name;
+        int channel = 0;
+        const int colonPos = name.indexOfChar(':');
+
+        if (colonPos > 0 && name.substring(0, colonPos).containsOnly("0123456789"))
+        {
+            channel = name.substring(0, colonPos).getIntValue();
+            parameterName = name.substring(colonPos + 1);
+
+            if (!juce::isPositiveAndNotGreaterThan(channel, (int) lookups.size()))
+            {
+                errors.add(where + "no instance plays channel " + juce::String(channel));
+                return {};
+            }
+        }
+
+        for (size_t i = 0; i < lookups.size(); ++i)
+        {
+            if (channel != 0 && (int) i != channel - 1)
+                continue;
+
+            auto* param = lookups[i]->find(parameterName);
+            if (param == nullptr)
+            {
+                errors.add(where + "unknown parameter '" + parameterName + "' (available: "
+                           + lookups[i]->getNames().joinIntoString(", ") + ")");
+                return {};
+            }
+
+            targets.push_back(param);
+        }
+
+        return targets;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterAutomation)
+};
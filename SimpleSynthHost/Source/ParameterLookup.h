@@ -0,0 +1,143 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <memory>
+#include <vector>
+
+#include "MultiTimbralProcessor.h"
+
+// Hashed name/ID -> parameter table for one processor, built once up front.
+// Keys are the lower-cased display name ("frequency", "filter cutoff") and
+// the host-side parameter ID, so --param, automation files and other front
+// ends resolve a parameter in O(1) and reject names that don't exist.
+//
+// A hosted VST3 parameter's ID is a number. The JUCE VST3 wrapper derives it
+// from the plugin's string ID ("glideMode") with String::hashCode(), so find()
+// resolves a string ID by hashing it the same way. String IDs are therefore
+// case-sensitive; display names are not.
+class ParameterLookup
+{
+public:
+    explicit ParameterLookup(juce::AudioProcessor& processor)
+    {
+        auto& params = processor.getParameters();
+        for (int i = 0; i < params.size(); ++i)
+        {
+            auto* param = params[i];
+            auto name = param->getName(128).trim();
+
+            if (auto* withId = dynamic_cast<juce::HostedAudioProcessorParameter*>(param))
+                byKey.set(withId->getParameterID().toLowerCase(), param);
+
+            names.add(name);
+            byKey.set(name.toLowerCase(), param);
+        }
+    }
+
+    // nullptr if no parameter has this ID or name
+    juce::AudioProcessorParameter* find(const juce::String& nameOrId) const
+    {
+        auto key = nameOrId.trim();
+
+        if (auto* param = byKey[key.toLowerCase()])
+            return param;
+
+        return byKey[getVst3ParameterID(key)];
+    }
+
+    // Display names, for listing in error messages
+    const juce::StringArray& getNames() const { return names; }
+
+    // The numeric ID the JUCE VST3 wrapper gives the parameter with this string
+    // ID: its hash with the sign bit cleared (JUCE_USE_STUDIO_ONE_COMPATIBLE_PARAMETERS)
+    static juce::String getVst3ParameterID(const juce::String& parameterID)
+    {
+        return juce::String((juce::uint32) parameterID.hashCode() & 0x7fffffffu);
+    }
+
+    // Converts a value to the parameter's normalised 0..1 range. Accepts real
+    // units ("440", "0.5"), a trailing 'n' for an already-normalised value
+    // ("0.25n"), or a choice's text ("Square"). Returns false if it can't be parsed.
+    static bool toNormalised(const juce::AudioProcessorParameter& param, const juce::String& text,
+                             float& normalisedValue)
+    {
+        auto valueText = text.trim();
+        if (valueText.isEmpty())
+            return false;
+
+        if (valueText.endsWithIgnoreCase("n") && isNumber(valueText.dropLastCharacters(1)))
+        {
+            normalisedValue = juce::jlimit(0.0f, 1.0f, valueText.dropLastCharacters(1).getFloatValue());
+            return true;
+        }
+
+        if (auto* ranged = dynamic_cast<const juce::RangedAudioParameter*>(&param))
+        {
+            if (isNumber(valueText))
+            {
+                normalisedValue = ranged->convertTo0to1(valueText.getFloatValue());
+                return true;
+            }
+        }
+        else if (isNumber(valueText) && param.isDiscrete() && param.getNumSteps() > 1)
+        {
+            // Hosted choice/int parameters: a plain number is the step index
+            normalisedValue = juce::jlimit(0.0f, 1.0f, valueText.getFloatValue() / (float) (param.getNumSteps() - 1));
+            return true;
+        }
+
+        // Real units on hosted parameters, or choice text: let the plugin parse it
+        if (!isNumber(valueText) && !matchesAnyStepText(param, valueText))
+            return false;
+
+        normalisedValue = juce::jlimit(0.0f, 1.0f, param.getValueForText(valueText));
+        return true;
+    }
+
+private:
+    juce::HashMap<juce::String, juce::AudioProcessorParameter*> byKey;
+    juce::StringArray names;
+
+    static bool isNumber(const juce::String& text)
+    {
+        return text.isNotEmpty()
+            && text.containsOnly("0123456789.-+eE")
+            && text.containsAnyOf("0123456789");
+    }
+
+    static bool matchesAnyStepText(const juce::AudioProcessorParameter& param, const juce::String& text)
+    {
+        const int numSteps = param.getNumSteps();
+        if (!param.isDiscrete() || numSteps <= 1 || numSteps > 1024)
+            return false;
+
+        for (int step = 0; step < numSteps; ++step)
+            if (param.getText((float) step / (float) (numSteps - 1), 128).equalsIgnoreCase(text))
+                return true;
+
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterLookup)
+};
+
+// One lookup per plugin instance: the processor itself, or the instances in
+// channel order for a MultiTimbralProcessor
+using ParameterLookups = std::vector<std::unique_ptr<ParameterLookup>>;
+
+inline ParameterLookups createParameterLookups(juce::AudioProcessor& processor)
+{
+    ParameterLookups lookups;
+
+    if (auto* multi = dynamic_cast<MultiTimbralProcessor*>(&processor))
+    {
+        for (int i = 0; i < multi->getNumInstances(); ++i)
+            lookups.push_back(std::make_unique<ParameterLookup>(multi->getInstance(i)));
+    }
+    else
+    {
+        lookups.push_back(std::make_unique<ParameterLookup>(processor));
+    }
+
+    return lookups;
+}
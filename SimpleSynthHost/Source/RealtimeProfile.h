@@ -0,0 +1,176 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <pthread.h>
+ #include <sched.h>
+ #include <sys/mman.h>
+#endif
+
+// Opt-in realtime profile for the interactive host (Linux only).
+// Live xruns are usually caused by page faults and scheduler noise rather than
+// DSP cost, so this locks memory, raises the audio thread to SCHED_FIFO and
+// pins the audio/UDP threads to dedicated CPUs.
+struct RealtimeProfile
+{
+    bool enabled = false;
+    int priority = 70;          // SCHED_FIFO priority for the audio callback thread
+    int audioCpu = -1;          // -1 = leave affinity alone
+    int udpCpu = -1;
+    int stackPrefaultBytes = 256 * 1024;
+    int warmUpBlocks = 4;       // Silent blocks pushed through the plugin after prepareToPlay
+
+    // Lock all current and future pages so nothing on the audio path can fault
+    static bool lockMemory()
+    {
+       #if JUCE_LINUX
+        return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+       #else
+        return false;
+       #endif
+    }
+
+    static void unlockMemory()
+    {
+       #if JUCE_LINUX
+        munlockall();
+       #endif
+    }
+
+    static bool setCurrentThreadRealtime(int fifoPriority)
+    {
+       #if JUCE_LINUX
+        sched_param param {};
+        param.sched_priority = juce::jlimit(sched_get_priority_min(SCHED_FIFO),
+                                            sched_get_priority_max(SCHED_FIFO),
+                                            fifoPriority);
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+       #else
+        juce::ignoreUnused(fifoPriority);
+        return false;
+       #endif
+    }
+
+    static bool pinCurrentThreadToCpu(int cpu)
+    {
+        if (cpu < 0)
+            return true;
+
+       #if JUCE_LINUX
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+       #else
+        return false;
+       #endif
+    }
+
+    // Touch the next N bytes of stack so the pages are resident before they are needed
+    static void prefaultStack(int numBytes)
+    {
+        constexpr int chunkSize = 4096;
+        volatile char chunk[chunkSize];
+        std::memset(const_cast<char*>(chunk), 0, sizeof(chunk));
+
+        if (numBytes > chunkSize)
+            prefaultStack(numBytes - chunkSize);
+
+        (void) chunk[0];  // Read after the recursion so it can't become a tail call
+    }
+};
+
+// Sits between the device and the AudioProcessorPlayer. On the first callback it
+// promotes the audio thread and prefaults its stack; after the player has prepared
+// the plugin it runs a few silent blocks so the plugin's working buffers are touched
+// before real audio starts.
+class RealtimeAudioCallback : public juce::AudioIODeviceCallback
+{
+public:
+    RealtimeAudioCallback(juce::AudioIODeviceCallback& targetCallback,
+                          juce::AudioProcessor* processorToWarm,
+                          const RealtimeProfile& rtProfile)
+        : target(targetCallback), processor(processorToWarm), profile(rtProfile)
+    {
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+    {
+        threadConfigured = false;
+        target.audioDeviceAboutToStart(device);
+
+        if (processor != nullptr && device != nullptr)
+            warmUp(device->getCurrentBufferSizeSamples());
+    }
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override
+    {
+        if (!threadConfigured)
+        {
+            threadConfigured = true;
+            configureAudioThread();
+        }
+
+        target.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                outputChannelData, numOutputChannels,
+                                                numSamples, context);
+    }
+
+    void audioDeviceStopped() override
+    {
+        target.audioDeviceStopped();
+    }
+
+    void audioDeviceError(const juce::String& errorMessage) override
+    {
+        target.audioDeviceError(errorMessage);
+    }
+
+    bool isRealtime() const { return realtimeGranted.load(); }
+    bool isPinned() const { return pinned.load(); }
+
+private:
+    juce::AudioIODeviceCallback& target;
+    juce::AudioProcessor* processor;
+    RealtimeProfile profile;
+    bool threadConfigured = false;
+    std::atomic<bool> realtimeGranted { false };
+    std::atomic<bool> pinned { false };
+
+    void configureAudioThread()
+    {
+        realtimeGranted = RealtimeProfile::setCurrentThreadRealtime(profile.priority);
+        pinned = profile.audioCpu >= 0 && RealtimeProfile::pinCurrentThreadToCpu(profile.audioCpu);
+        RealtimeProfile::prefaultStack(profile.stackPrefaultBytes);
+    }
+
+    void warmUp(int blockSize)
+    {
+        const juce::ScopedLock sl(processor->getCallbackLock());
+
+        juce::AudioBuffer<float> scratch(juce::jmax(processor->getTotalNumInputChannels(),
+                                                    processor->getTotalNumOutputChannels()),
+                                         juce::jmax(1, blockSize));
+        juce::MidiBuffer midi;
+
+        for (int i = 0; i < profile.warmUpBlocks; ++i)
+        {
+            scratch.clear();
+            midi.clear();
+            processor->processBlock(scratch, midi);
+        }
+
+        processor->reset();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeAudioCallback)
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Virtual output device that drives the audio callback from a high-resolution
+// timer, so the interactive path can run on machines without sound hardware.
+// In max-speed mode blocks are rendered back-to-back with no pacing (stress test).
+class SimulatedAudioIODevice : public juce::AudioIODevice,
+                               private juce::Thread
+{
+public:
+    static constexpr const char* typeName = "Simulated";
+    static constexpr const char* deviceName = "Simulated Output";
+
+    explicit SimulatedAudioIODevice(bool runAtMaxSpeed)
+        : AudioIODevice(deviceName, typeName),
+          Thread("Simulated audio"),
+          maxSpeed(runAtMaxSpeed)
+    {
+    }
+
+    ~SimulatedAudioIODevice() override
+    {
+        close();
+    }
+
+    juce::StringArray getOutputChannelNames() override { return { "Left", "Right" }; }
+    juce::StringArray getInputChannelNames() override { return { "Left", "Right" }; }
+
+    juce::Array<double> getAvailableSampleRates() override
+    {
+        return { 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    }
+
+    juce::Array<int> getAvailableBufferSizes() override
+    {
+        return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    }
+
+    int getDefaultBufferSize() override { return 512; }
+
+    juce::String open(const juce::BigInteger& inputChannels,
+                      const juce::BigInteger& outputChannels,
+                      double newSampleRate,
+                      int newBufferSize) override
+    {
+        close();
+
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        bufferSize = newBufferSize > 0 ? newBufferSize : getDefaultBufferSize();
+        activeInputs = inputChannels;
+        activeInputs.setRange(2, activeInputs.getHighestBit() + 1, false);
+        activeOutputs = outputChannels;
+        activeOutputs.setRange(2, activeOutputs.getHighestBit() + 1, false);
+
+        inputBuffer.setSize(juce::jmax(1, activeInputs.countNumberOfSetBits()), bufferSize);
+        outputBuffer.setSize(juce::jmax(1, activeOutputs.countNumberOfSetBits()), bufferSize);
+
+        xruns = 0;
+        opened = true;
+        return {};
+    }
+
+    void close() override
+    {
+        stop();
+        opened = false;
+    }
+
+    bool isOpen() override { return opened; }
+
+    void start(juce::AudioIODeviceCallback* newCallback) override
+    {
+        if (!opened || newCallback == nullptr)
+            return;
+
+        stop();
+        newCallback->audioDeviceAboutToStart(this);
+
+        {
+            const juce::ScopedLock sl(callbackLock);
+            callback = newCallback;
+        }
+
+        startThread(maxSpeed ? juce::Thread::Priority::normal : juce::Thread::Priority::highest);
+    }
+
+    void stop() override
+    {
+        stopThread(2000);
+
+        juce::AudioIODeviceCallback* oldCallback = nullptr;
+        {
+            const juce::ScopedLock sl(callbackLock);
+            std::swap(oldCallback, callback);
+        }
+
+        if (oldCallback != nullptr)
+            oldCallback->audioDeviceStopped();
+    }
+
+    bool isPlaying() override { return isThreadRunning(); }
+    juce::String getLastError() override { return {}; }
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return sampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    juce::BigInteger getActiveInputChannels() const override { return activeInputs; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+
+    // A block is counted as an xrun when the callback finished after the next block was due
+    int getXRunCount() const noexcept override { return xruns.load(); }
+
+    bool isMaxSpeed() const { return maxSpeed; }
+
+private:
+    const bool maxSpeed;
+    double sampleRate = 44100.0;
+    int bufferSize = 512;
+    juce::BigInteger activeInputs, activeOutputs;
+    juce::AudioBuffer<float> inputBuffer, outputBuffer;
+    bool opened = false;
+    std::atomic<int> xruns { 0 };
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* callback = nullptr;
+
+    void run() override
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((double) bufferSize / sampleRate));
+        const int numInputs = activeInputs.countNumberOfSetBits();
+        const int numOutputs = activeOutputs.countNumberOfSetBits();
+
+        auto nextDeadline = Clock::now() + period;
+        juce::uint64 hostTimeNs = 0;
+
+        while (!threadShouldExit())
+        {
+            inputBuffer.clear();
+            outputBuffer.clear();
+
+            hostTimeNs = (juce::uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count();
+
+            juce::AudioIODeviceCallbackContext context;
+            context.hostTimeNs = &hostTimeNs;
+
+            {
+                const juce::ScopedLock sl(callbackLock);
+                if (callback != nullptr)
+                    callback->audioDeviceIOCallbackWithContext(inputBuffer.getArrayOfReadPointers(), numInputs,
+                                                               outputBuffer.getArrayOfWritePointers(), numOutputs,
+                                                               bufferSize, context);
+            }
+
+            if (maxSpeed)
+                continue;
+
+            const auto now = Clock::now();
+            if (now > nextDeadline)
+            {
+                // Missed the slot: count it and re-anchor rather than bursting to catch up
+                ++xruns;
+                nextDeadline = now + period;
+                continue;
+            }
+
+            std::this_thread::sleep_until(nextDeadline);
+            nextDeadline += period;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedAudioIODevice)
+};
+
+class SimulatedAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    explicit SimulatedAudioIODeviceType(bool runAtMaxSpeed)
+        : AudioIODeviceType(SimulatedAudioIODevice::typeName), maxSpeed(runAtMaxSpeed)
+    {
+    }
+
+    void scanForDevices() override {}
+
+    juce::StringArray getDeviceNames(bool /*wantInputNames*/) const override
+    {
+        return { SimulatedAudioIODevice::deviceName };
+    }
+
+    int getDefaultDeviceIndex(bool /*forInput*/) const override { return 0; }
+
+    int getIndexOfDevice(juce::AudioIODevice* device, bool /*asInput*/) const override
+    {
+        return dynamic_cast<SimulatedAudioIODevice*>(device) != nullptr ? 0 : -1;
+    }
+
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override
+    {
+        if (outputDeviceName == SimulatedAudioIODevice::deviceName
+            || inputDeviceName == SimulatedAudioIODevice::deviceName)
+            return new SimulatedAudioIODevice(maxSpeed);
+
+        return nullptr;
+    }
+
+private:
+    const bool maxSpeed;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedAudioIODeviceType)
+};
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""End-to-end MIDI-to-audio latency harness for SimpleSynthHost.
+
+Sends note-ons to the host's UDP MIDI port and watches the rendered output
+coming back over the host's UDP audio tap. For each note the latency is the
+time from sending the note-on to the first output sample above the threshold.
+
+Start the host with the tap enabled, e.g. on a headless node:
+
+    SimpleSynthHost --simulated --blocksize 128 --audio-tap 9998
+
+then run:
+
+    python3 latency_harness.py --notes 200
+
+Send and callback times both come from the monotonic clock, so host and
+harness must run on the same (Linux) machine.
+"""
+import argparse
+import random
+import socket
+import statistics
+import struct
+import sys
+import time
+from array import array
+
+HEADER = struct.Struct("=4sQdII")  # magic, callback time ns, sample rate, samples, output latency
+
+
+def parse_packet(data):
+    if len(data) < HEADER.size:
+        return None
+    magic, time_ns, sample_rate, num_samples, latency = HEADER.unpack_from(data)
+    if magic != b"SSTP":
+        return None
+    samples = array("f")
+    samples.frombytes(data[HEADER.size:HEADER.size + num_samples * 4])
+    return time_ns, sample_rate, latency, samples
+
+
+def first_onset(samples, threshold):
+    for i, value in enumerate(samples):
+        if abs(value) > threshold:
+            return i
+    return None
+
+
+def wait_for_onset(tap, send_ns, threshold, timeout_s):
+    """Return the onset time (ns) of the first loud sample rendered after send_ns."""
+    deadline = time.monotonic() + timeout_s
+    while time.monotonic() < deadline:
+        try:
+            data = tap.recv(65536)
+        except socket.timeout:
+            continue
+        packet = parse_packet(data)
+        if packet is None:
+            continue
+        time_ns, sample_rate, latency, samples = packet
+        if time_ns < send_ns:
+            continue  # Block started before the note was sent
+        index = first_onset(samples, threshold)
+        if index is not None:
+            return time_ns + int((latency + index) * 1e9 / sample_rate)
+    return None
+
+
+def wait_for_silence(tap, threshold, timeout_s):
+    deadline = time.monotonic() + timeout_s
+    quiet_blocks = 0
+    while time.monotonic() < deadline and quiet_blocks < 4:
+        try:
+            packet = parse_packet(tap.recv(65536))
+        except socket.timeout:
+            continue
+        if packet is None:
+            continue
+        quiet_blocks = quiet_blocks + 1 if first_onset(packet[3], threshold) is None else 0
+    return quiet_blocks >= 4
+
+
+def percentile(sorted_values, fraction):
+    index = min(len(sorted_values) - 1, max(0, int(round(fraction * (len(sorted_values) - 1)))))
+    return sorted_values[index]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure MIDI-to-audio latency of a running SimpleSynthHost")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--midi-port", type=int, default=9999)
+    parser.add_argument("--tap-port", type=int, default=9998)
+    parser.add_argument("--notes", type=int, default=100)
+    parser.add_argument("--note", type=int, default=69)
+    parser.add_argument("--threshold", type=float, default=1e-3)
+    parser.add_argument("--timeout", type=float, default=1.0, help="seconds to wait for each onset")
+    args = parser.parse_args()
+
+    midi = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tap = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tap.bind(("127.0.0.1", args.tap_port))
+    tap.settimeout(0.05)
+
+    note_on = bytes([0x90, args.note, 0x64])
+    note_off = bytes([0x80, args.note, 0x00])
+
+    latencies_ms = []
+    misses = 0
+
+    for i in range(args.notes):
+        if not wait_for_silence(tap, args.threshold, args.timeout):
+            print("No quiet output from the tap - is the host running with --audio-tap?", file=sys.stderr)
+            return 1
+
+        # Random offset so note-ons land at different points within a block
+        time.sleep(random.uniform(0.01, 0.03))
+
+        send_ns = time.monotonic_ns()
+        midi.sendto(note_on, (args.host, args.midi_port))
+        onset_ns = wait_for_onset(tap, send_ns, args.threshold, args.timeout)
+        midi.sendto(note_off, (args.host, args.midi_port))
+
+        if onset_ns is None:
+            misses += 1
+            continue
+
+        latencies_ms.append((onset_ns - send_ns) / 1e6)
+
+    if not latencies_ms:
+        print("No onsets detected.", file=sys.stderr)
+        return 1
+
+    values = sorted(latencies_ms)
+    jitter = statistics.pstdev(values)
+    print(f"notes={len(values)} missed={misses}")
+    print(f"latency ms: min={values[0]:.3f} p50={percentile(values, 0.50):.3f} "
+          f"p99={percentile(values, 0.99):.3f} max={values[-1]:.3f}")
+    print(f"jitter ms: stddev={jitter:.3f} p99-p50={percentile(values, 0.99) - percentile(values, 0.50):.3f}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Builds a SimpleSynth preset bank (.ssbank).
+
+Each preset is given as NAME:ID=VALUE,ID=VALUE,... with values in real units
+(frequency in Hz, gain 0..1, waveform 0=Sine 1=Square 2=Sawtooth 3=Triangle).
+Parameters left out keep their current value when the preset is selected.
+
+    python3 make_preset_bank.py SimpleSynth.ssbank \\
+        "Soft Sine:waveform=0,gain=0.5" \\
+        "Square Lead:waveform=1,gain=0.8" \\
+        "Saw Bass:waveform=2,gain=0.9"
+
+The plugin reads SIMPLESYNTH_PRESET_BANK, or SimpleSynth/SimpleSynth.ssbank in
+the user application-data folder (~/.config on Linux). MIDI program change N
+selects the preset at position N.
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = b"SSBK"
+VERSION = 1
+MAX_PRESETS = 128
+NAME_LENGTH = 32
+ID_LENGTH = 16
+
+HEADER = struct.Struct("<4sIII")
+INDEX_ENTRY = struct.Struct("<%dsII" % NAME_LENGTH)
+VALUE_RECORD = struct.Struct("<%dsf" % ID_LENGTH)
+
+
+def parse_preset(text):
+    name, _, values = text.partition(":")
+    if not name or len(name.encode("utf-8")) > NAME_LENGTH:
+        raise ValueError("preset name must be 1-%d bytes: %r" % (NAME_LENGTH, name))
+
+    records = []
+    for item in filter(None, (v.strip() for v in values.split(","))):
+        parameter_id, _, value = item.partition("=")
+        if not value or len(parameter_id.encode("utf-8")) > ID_LENGTH:
+            raise ValueError("bad value %r in preset %r" % (item, name))
+        records.append((parameter_id, float(value)))
+    return name, records
+
+
+def build_bank(presets):
+    index = bytearray()
+    values = bytearray()
+    values_start = HEADER.size + INDEX_ENTRY.size * MAX_PRESETS
+
+    for name, records in presets:
+        index += INDEX_ENTRY.pack(name.encode("utf-8"), values_start + len(values), len(records))
+        for parameter_id, value in records:
+            values += VALUE_RECORD.pack(parameter_id.encode("utf-8"), value)
+
+    index += bytes(INDEX_ENTRY.size * (MAX_PRESETS - len(presets)))
+    return HEADER.pack(MAGIC, VERSION, len(presets), 0) + bytes(index) + bytes(values)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a SimpleSynth preset bank")
+    parser.add_argument("output")
+    parser.add_argument("presets", nargs="+", help="NAME:ID=VALUE,ID=VALUE,...")
+    args = parser.parse_args()
+
+    if len(args.presets) > MAX_PRESETS:
+        sys.exit("at most %d presets per bank" % MAX_PRESETS)
+
+    try:
+        presets = [parse_preset(p) for p in args.presets]
+    except ValueError as e:
+        sys.exit(str(e))
+
+    with open(args.output, "wb") as f:
+        f.write(build_bank(presets))
+
+    print("Wrote %d presets to %s" % (len(presets), args.output))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,7 +1,10 @@
 #!/usr/bin/env python3
+import os
+import re
 import subprocess
 import struct
 import sys
+import tempfile
 
 # Create a MIDI sequence: Note On (C4, vel 100) -> wait -> Note Off
 midi_sequence = bytes([
@@ -96,7 +99,181 @@ except subprocess.TimeoutExpired:
 except Exception as e:
     print(f"✗ Error: {e}")
 
+print()
+
+# Test 3: Parameters looked up by the plugin's camelCase IDs
+print("[TEST 3] Parameter lookup by ID")
+print("-" * 60)
+print("Running: ... | SimpleSynthHost --param glideMode=Always --param bendRange=12 --duration 0.2")
+
+try:
+    proc = subprocess.Popen(
+        [r"C:\code\juce\SimpleSynthHost\cmake-build\Debug\SimpleSynthHost.exe",
+         "--param", "glideMode=Always",
+         "--param", "bendRange=12",
+         "--duration", "0.2"],
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        creationflags=subprocess.CREATE_NO_WINDOW
+    )
+
+    audio_data, stderr = proc.communicate(input=midi_sequence, timeout=10)
+
+    print(f"Exit code: {proc.returncode}")
+    if proc.returncode == 0 and len(audio_data) > 0:
+        print("✓ camelCase IDs resolved")
+    else:
+        print(f"✗ camelCase IDs rejected: {stderr.decode('utf-8', errors='ignore')[:200]}")
+
+    # An ID the plugin doesn't have must still be an error
+    proc = subprocess.Popen(
+        [r"C:\code\juce\SimpleSynthHost\cmake-build\Debug\SimpleSynthHost.exe",
+         "--param", "noSuchParameter=1",
+         "--duration", "0.2"],
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        creationflags=subprocess.CREATE_NO_WINDOW
+    )
+
+    audio_data, stderr = proc.communicate(input=midi_sequence, timeout=10)
+
+    if proc.returncode != 0 and "unknown parameter" in stderr.decode('utf-8', errors='ignore'):
+        print("✓ Unknown ID rejected")
+    else:
+        print(f"✗ Unknown ID accepted (exit code {proc.returncode})")
+
+except subprocess.TimeoutExpired:
+    print("✗ Process timed out")
+    proc.kill()
+except Exception as e:
+    print(f"✗ Error: {e}")
+
+# Test 4: Nothing in the audio callback allocates while parameters, programs
+# and MIDI change every block. Needs a host configured with
+# -DSIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS=ON; the guard spans the whole
+# callback, so it also sees the VST3 wrapper applying parameter changes.
+print("[TEST 4] Audio-thread allocations under automation, programs and MIDI")
+print("-" * 60)
+
+guard_failed = False
+work_dir = tempfile.mkdtemp(prefix="simplesynth-guard-")
+automation_path = os.path.join(work_dir, "stress.txt")
+bank_path = os.path.join(work_dir, "stress.ssbank")
+
+with open(automation_path, "w") as automation:
+    for i in range(2000):
+        t = i / 1000
+        automation.write(f"{t} gain {0.5 + 0.5 * (i % 2)}\n")
+        automation.write(f"{t} waveform {i % 4}\n")
+        automation.write(f"{t} frequency {100 + i % 900}\n")
+        automation.write(f"{t} cutoff {200 + (i * 37) % 8000}\n")
+        automation.write(f"{t} glideMode {i % 3}\n")
+        automation.write(f"{t} delayTime {50 + (i % 10) * 20}\n")
+
+subprocess.run([sys.executable, os.path.join(os.path.dirname(os.path.abspath(__file__)), "make_preset_bank.py"),
+                bank_path, "Soft Sine:waveform=0,gain=0.5", "Square Lead:waveform=1,gain=0.8",
+                "Saw Bass:waveform=2,gain=0.9"], check=True)
+
+# Notes, program changes, controllers and pitch bend on every channel's worth of traffic
+stress_midi = bytearray()
+for i in range(200):
+    note = 48 + i % 24
+    stress_midi += bytes([0x90, note, 100])
+    stress_midi += bytes([0xC0, i % 3])
+    stress_midi += bytes([0xB0, 7, (i * 13) % 128])
+    stress_midi += bytes([0xB0, 1, (i * 7) % 128])
+    stress_midi += bytes([0xE0, 0x00, (i * 5) % 128])
+    stress_midi += bytes([0x80, note, 0])
+
+try:
+    proc = subprocess.Popen(
+        [r"C:\code\juce\SimpleSynthHost\cmake-build\Debug\SimpleSynthHost.exe",
+         "--automation", automation_path,
+         "--blocksize", "64",
+         "--duration", "2"],
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        env=dict(os.environ, SIMPLESYNTH_PRESET_BANK=bank_path),
+        creationflags=subprocess.CREATE_NO_WINDOW
+    )
+
+    audio_data, stderr = proc.communicate(input=bytes(stress_midi), timeout=30)
+    stderr_text = stderr.decode('utf-8', errors='ignore')
+    match = re.search(r"audio-thread allocations: (\d+)", stderr_text)
+
+    print(f"Exit code: {proc.returncode}")
+    if proc.returncode != 0:
+        guard_failed = True
+        print(f"✗ Render failed: {stderr_text[:200]}")
+    elif match is None:
+        print("⚠ Host built without SIMPLESYNTHHOST_CHECK_AUDIO_ALLOCATIONS; allocation check skipped")
+    elif int(match.group(1)) == 0:
+        print("✓ No allocations in the audio callback")
+    else:
+        guard_failed = True
+        print(f"✗ {match.group(1)} allocations in the audio callback")
+
+except subprocess.TimeoutExpired:
+    guard_failed = True
+    print("✗ Process timed out")
+    proc.kill()
+except Exception as e:
+    guard_failed = True
+    print(f"✗ Error: {e}")
+
+# Test 5: A malformed bank is ignored (the default bank is used), never read
+# past its end. Each bank has one preset whose values offset or count points
+# beyond the file.
+print("[TEST 5] Malformed preset banks")
+print("-" * 60)
+
+bank_failed = False
+header = struct.Struct("<4sIII")
+index_entry = struct.Struct("<32sII")
+index_end = header.size + index_entry.size * 128
+malformed_banks = {
+    "offset past end": (index_end + 1_000_000, 1),
+    "count past end": (index_end, 1_000_000),
+}
+
+for label, (values_offset, num_values) in malformed_banks.items():
+    bad_bank_path = os.path.join(work_dir, "malformed.ssbank")
+    with open(bad_bank_path, "wb") as bank:
+        bank.write(header.pack(b"SSBK", 1, 1, 0))
+        bank.write(index_entry.pack(b"Broken", values_offset, num_values))
+        bank.write(bytes(index_entry.size * 127))
+
+    try:
+        proc = subprocess.Popen(
+            [r"C:\code\juce\SimpleSynthHost\cmake-build\Debug\SimpleSynthHost.exe", "--duration", "0.1"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            env=dict(os.environ, SIMPLESYNTH_PRESET_BANK=bad_bank_path),
+            creationflags=subprocess.CREATE_NO_WINDOW
+        )
+
+        audio_data, stderr = proc.communicate(input=midi_sequence, timeout=10)
+        if proc.returncode == 0 and len(audio_data) > 0:
+            print(f"✓ {label}: bank rejected, rendered {len(audio_data)} bytes")
+        else:
+            bank_failed = True
+            print(f"✗ {label}: exit code {proc.returncode}")
+
+    except subprocess.TimeoutExpired:
+        bank_failed = True
+        print(f"✗ {label}: process timed out")
+        proc.kill()
+    except Exception as e:
+        bank_failed = True
+        print(f"✗ {label}: error: {e}")
+
 print()
 print("=" * 60)
 print("Test complete!")
 print("=" * 60)
+
+sys.exit(1 if guard_failed or bank_failed else 0)